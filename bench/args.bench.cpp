@@ -0,0 +1,62 @@
+#include <ferrugo/fmt/fmt.hpp>
+#include <string>
+
+#include "bench.hpp"
+
+using namespace ferrugo;
+
+/*
+ * Formatting runtime arguments from a dynamic_format_arg_store against the std::vector<arg_ref> which wraps the
+ * arguments of a regular call. The store is measured both rebuilt for every call (copying the values into its
+ * arena) and built once.
+ */
+
+namespace
+{
+
+constexpr std::size_t count = 1'000'000;
+
+void run()
+{
+    const std::string text = "a string too long for the small string buffer";
+    std::string out;
+
+    bench::measure(
+        "args - std::vector<arg_ref>",
+        count,
+        [&](std::size_t i)
+        {
+            out.clear();
+            return fmt::format_append(out, FERRUGO_FMT_STRING("{} {} {} {name}"))(
+                       static_cast<int>(i), text, 0.5, fmt::arg("name", text))
+                .size();
+        });
+
+    fmt::dynamic_format_arg_store store;
+    bench::measure(
+        "args - dynamic_format_arg_store, built per call",
+        count,
+        [&](std::size_t i)
+        {
+            store.clear();
+            store.push_back(static_cast<int>(i));
+            store.push_back(text);
+            store.push_back(0.5);
+            store.push_back(fmt::arg("name", text));
+            out.clear();
+            return fmt::format_append(out, FERRUGO_FMT_STRING("{} {} {} {name}"))(store).size();
+        });
+
+    bench::measure(
+        "args - dynamic_format_arg_store, built once",
+        count,
+        [&](std::size_t)
+        {
+            out.clear();
+            return fmt::format_append(out, FERRUGO_FMT_STRING("{} {} {} {name}"))(store).size();
+        });
+}
+
+}  // namespace
+
+BENCHMARK("args", &run);
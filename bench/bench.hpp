@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/*
+ * Minimal benchmark harness: each benchmark registers itself with BENCHMARK and reports its time per item with
+ * `measure`. The results are only printed, there are no thresholds.
+ */
+
+namespace bench
+{
+
+struct benchmark
+{
+    std::string_view name;
+    void (*run)();
+};
+
+inline std::vector<benchmark>& benchmarks()
+{
+    static std::vector<benchmark> result;
+    return result;
+}
+
+struct registrar
+{
+    registrar(std::string_view name, void (*run)())
+    {
+        benchmarks().push_back(benchmark{ name, run });
+    }
+};
+
+// Keeps the results of the measured code alive, so that the optimizer cannot drop it.
+inline volatile std::size_t checksum = 0;
+
+void report(std::string_view name, std::size_t items, std::chrono::steady_clock::duration elapsed);
+
+// Runs `fn(i)` for i in [0, items), and reports the time per item. `fn` returns a value to add to the checksum.
+template <class Fn>
+void measure(std::string_view name, std::size_t items, Fn fn)
+{
+    std::size_t sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < items; ++i)
+    {
+        sum += fn(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    checksum = checksum + sum;
+    report(name, items, elapsed);
+}
+
+}  // namespace bench
+
+#define BENCH_CONCAT_IMPL(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_IMPL(a, b)
+#define BENCHMARK(name, function) static const ::bench::registrar BENCH_CONCAT(bench_registrar_, __LINE__){ name, function }
@@ -0,0 +1,26 @@
+#include <ferrugo/fmt/fmt.hpp>
+#include <string_view>
+
+#include "bench.hpp"
+
+using namespace ferrugo;
+
+void bench::report(std::string_view name, std::size_t items, std::chrono::steady_clock::duration elapsed)
+{
+    const double ns = std::chrono::duration<double, std::nano>{ elapsed }.count();
+    fmt::println("{}: {} items in {} ms, {} ns per item")(name, items, ns / 1e6, ns / static_cast<double>(items));
+}
+
+// Runs the benchmarks whose names contain the first argument, or all of them.
+int main(int argc, char** argv)
+{
+    const std::string_view filter = argc > 1 ? argv[1] : "";
+    for (const bench::benchmark& b : bench::benchmarks())
+    {
+        if (b.name.find(filter) != std::string_view::npos)
+        {
+            b.run();
+        }
+    }
+    return 0;
+}
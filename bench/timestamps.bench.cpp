@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <ferrugo/fmt/fmt.hpp>
+#include <string>
+
+#include "bench.hpp"
+
+using namespace ferrugo;
+
+/*
+ * Formatting of system_clock time points ("{:%F %T}") against std::gmtime and std::strftime, with the fraction of
+ * a second printed by std::snprintf. Log timestamps are close to each other and mostly share their second, which the
+ * formatter caches; the spread timestamps change the second on every call.
+ */
+
+namespace
+{
+
+using sys_microseconds = std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds>;
+
+constexpr std::size_t count = 10'000'000;
+
+// Timestamps from 2023-11-14, `step` microseconds apart.
+template <std::int64_t step>
+auto timestamp(std::size_t i) -> sys_microseconds
+{
+    return sys_microseconds{ std::chrono::microseconds{ 1'700'000'000'000'000 + step * static_cast<std::int64_t>(i) } };
+}
+
+auto strftime_timestamp(sys_microseconds tp, char (&out)[64]) -> std::size_t
+{
+    const auto secs = std::chrono::floor<std::chrono::seconds>(tp);
+    const std::time_t time = std::chrono::system_clock::to_time_t(secs);
+    std::tm tm{};
+#if defined(_WIN32)
+    gmtime_s(&tm, &time);
+#else
+    gmtime_r(&time, &tm);
+#endif
+    const std::size_t size = std::strftime(out, sizeof(out), "%Y-%m-%d %H:%M:%S", &tm);
+    const int fraction = std::snprintf(out + size, sizeof(out) - size, ".%06d", static_cast<int>((tp - secs).count()));
+    return size + static_cast<std::size_t>(fraction);
+}
+
+template <std::int64_t step>
+void run(std::string_view name)
+{
+    {
+        char expected[64];
+        const std::size_t size = strftime_timestamp(timestamp<step>(count - 1), expected);
+        if (fmt::format(FERRUGO_FMT_STRING("{:%F %T}"))(timestamp<step>(count - 1)) != std::string_view{ expected, size })
+        {
+            fmt::println("{}: fmt and strftime disagree")(name);
+            std::abort();
+        }
+    }
+
+    bench::measure(
+        fmt::format("{} - strftime")(name),
+        count,
+        [](std::size_t i)
+        {
+            char out[64];
+            return strftime_timestamp(timestamp<step>(i), out);
+        });
+
+    bench::measure(
+        fmt::format("{} - fmt::format")(name),
+        count,
+        [](std::size_t i) { return fmt::format(FERRUGO_FMT_STRING("{:%F %T}"))(timestamp<step>(i)).size(); });
+
+    std::string out;
+    bench::measure(
+        fmt::format("{} - fmt::format_append")(name),
+        count,
+        [&](std::size_t i)
+        {
+            out.clear();
+            return fmt::format_append(out, FERRUGO_FMT_STRING("{:%F %T}"))(timestamp<step>(i)).size();
+        });
+}
+
+}  // namespace
+
+BENCHMARK("timestamps - log lines", [] { run<1>("timestamps - log lines"); });
+BENCHMARK("timestamps - spread", [] { run<7'000'001>("timestamps - spread"); });
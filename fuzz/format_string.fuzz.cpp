@@ -0,0 +1,145 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ferrugo/fmt/fmt.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Fuzz target of the format string parser. Any input must either format or throw format_error - crashes, other
+ * exceptions and sanitizer reports are bugs. The runtime parser is also checked against the template registry,
+ * which compiles the same grammar into its own layout.
+ */
+
+using namespace ferrugo;
+
+namespace
+{
+
+template <class Format>
+auto try_format(const Format& format) -> std::optional<std::string>
+{
+    const int number = 42;
+    const std::string text = "text";
+    const double real = 3.5;
+    try
+    {
+        return format(fmt::detail::wrap_args(number, text, real, fmt::arg("name", number), fmt::arg("n", text)));
+    }
+    catch (const fmt::format_error&)
+    {
+        return std::nullopt;
+    }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    const std::string_view input{ reinterpret_cast<const char*>(data), size };
+
+    const std::optional<std::string> expected = try_format(
+        [&](const std::vector<fmt::detail::arg_ref>& args) { return fmt::detail::format_string{ input }.format(args); });
+
+    std::optional<std::string> registry_data;
+    try
+    {
+        registry_data = fmt::template_registry::compile({ { "input", std::string{ input } } });
+    }
+    catch (const fmt::format_error&)
+    {
+    }
+    const std::optional<std::string> actual = registry_data
+        ? try_format([&](const std::vector<fmt::detail::arg_ref>& args)
+                     { return fmt::template_registry{ *registry_data }.at("input").format(args); })
+        : std::nullopt;
+
+    if (expected != actual)
+    {
+        std::fprintf(stderr, "format_string and template_registry disagree\n");
+        std::abort();
+    }
+    return 0;
+}
+
+#if defined(FERRUGO_FMT_STANDALONE_FUZZER)
+
+namespace
+{
+
+void run_one(const std::string& input)
+{
+    LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()), input.size());
+}
+
+// Random edits of the inputs: fragments of the format grammar, random bytes and deletions.
+void run_mutations(const std::vector<std::string>& inputs, long runs)
+{
+    static const std::string_view fragments[] = {
+        "{", "}", "{{", "}}", ":", "#", "x", "X", "b", "o", "d", "0", "1", "9", "name", "n",
+        "2147483647", "2147483648", "4294967295", "4294967296", "18446744073709551615",
+    };
+    std::mt19937_64 engine{ 0 };
+    const auto random = [&](std::size_t n) { return static_cast<std::size_t>(engine() % n); };
+    for (long run = 0; run < runs; ++run)
+    {
+        std::string input = inputs.empty() ? std::string{} : inputs[random(inputs.size())];
+        for (std::size_t edit = random(8); edit > 0; --edit)
+        {
+            const std::size_t pos = random(input.size() + 1);
+            switch (random(3))
+            {
+                case 0: input.insert(pos, fragments[random(std::size(fragments))]); break;
+                case 1: input.insert(input.begin() + pos, static_cast<char>(random(256))); break;
+                default: input.erase(pos, random(4)); break;
+            }
+        }
+        run_one(input);
+    }
+}
+
+}  // namespace
+
+/*
+ * Without libFuzzer: replays the given inputs (e.g. the corpus or a crash reproducer), or stdin if there are none.
+ * With `-runs=N` first, it also formats N random mutations of the inputs.
+ */
+int main(int argc, char** argv)
+{
+    long runs = 0;
+    int first = 1;
+    if (argc > 1 && std::string_view{ argv[1] }.substr(0, 6) == "-runs=")
+    {
+        runs = std::atol(argv[1] + 6);
+        first = 2;
+    }
+    std::vector<std::string> inputs;
+    for (int i = first; i < argc; ++i)
+    {
+        std::ifstream file{ argv[i], std::ios::binary };
+        if (!file)
+        {
+            std::cerr << "cannot open " << argv[i] << "\n";
+            return 1;
+        }
+        inputs.emplace_back(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+    }
+    if (inputs.empty() && runs == 0)
+    {
+        inputs.emplace_back(std::istreambuf_iterator<char>{ std::cin }, std::istreambuf_iterator<char>{});
+    }
+    for (const std::string& input : inputs)
+    {
+        run_one(input);
+    }
+    run_mutations(inputs, runs);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ferrugo/fmt/format.hpp>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ferrugo
+{
+
+namespace fmt
+{
+
+/*
+ * Owning list of heterogeneous arguments built at runtime, e.g. from a scripting layer:
+ *
+ *     fmt::dynamic_format_arg_store store;
+ *     store.push_back(42);
+ *     store.push_back(fmt::arg("name", std::string{ "Alice" }));
+ *     fmt::format("{name} is {}")(store);
+ *
+ * The values (and the characters of strings and argument names) are copied into a single arena of large blocks
+ * rather than allocated separately; each argument is then formatted through a single indirect call of its arg_ref.
+ * Wrap a value in std::reference_wrapper to store it by reference instead.
+ */
+class dynamic_format_arg_store
+{
+public:
+    static constexpr std::size_t default_block_size = 4096;
+
+    explicit dynamic_format_arg_store(std::size_t block_size = default_block_size)
+        : m_block_size{ block_size }
+        , m_blocks{}
+        , m_large_blocks{}
+        , m_used{ 0 }
+        , m_destructors{}
+        , m_args{}
+    {
+    }
+
+    dynamic_format_arg_store(const dynamic_format_arg_store&) = delete;
+    dynamic_format_arg_store& operator=(const dynamic_format_arg_store&) = delete;
+
+    ~dynamic_format_arg_store()
+    {
+        clear();
+    }
+
+    template <class T>
+    void push_back(const T& value)
+    {
+        if constexpr (detail::is_named_arg<T>::value)
+        {
+            const std::string_view name = store_string(value.m_name);
+            push_back(value.m_value);
+            m_args.back().m_name = name;
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            m_args.emplace_back(store_value(store_string(value)));
+        }
+        else
+        {
+            m_args.emplace_back(store_value(value));
+        }
+    }
+
+    template <class T>
+    void push_back(std::reference_wrapper<T> value)
+    {
+        m_args.emplace_back(value.get());
+    }
+
+    void clear()
+    {
+        for (auto it = m_destructors.rbegin(); it != m_destructors.rend(); ++it)
+        {
+            it->first(it->second);
+        }
+        m_destructors.clear();
+        m_args.clear();
+        m_blocks.clear();
+        m_large_blocks.clear();
+        m_used = 0;
+    }
+
+    std::size_t size() const
+    {
+        return m_args.size();
+    }
+
+    const std::vector<detail::arg_ref>& args() const
+    {
+        return m_args;
+    }
+
+private:
+    using destructor = void (*)(void*);
+
+    std::size_t m_block_size;
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    std::vector<std::unique_ptr<std::byte[]>> m_large_blocks;
+    std::size_t m_used;
+    std::vector<std::pair<destructor, void*>> m_destructors;
+    std::vector<detail::arg_ref> m_args;
+
+    void* allocate(std::size_t size, std::size_t alignment)
+    {
+        if (size + alignment > m_block_size)
+        {
+            // Oversized values get a block of their own.
+            std::size_t space = size + alignment;
+            void* ptr = m_large_blocks.emplace_back(new std::byte[space]).get();
+            return std::align(alignment, size, ptr, space);
+        }
+        // The blocks are only aligned for new, so the alignment is applied to the address rather than to the offset.
+        void* ptr = nullptr;
+        std::size_t space = 0;
+        if (!m_blocks.empty())
+        {
+            ptr = m_blocks.back().get() + m_used;
+            space = m_block_size - m_used;
+        }
+        if (!ptr || !std::align(alignment, size, ptr, space))
+        {
+            ptr = m_blocks.emplace_back(new std::byte[m_block_size]).get();
+            space = m_block_size;
+            std::align(alignment, size, ptr, space);
+        }
+        m_used = m_block_size - space + size;
+        return ptr;
+    }
+
+    auto store_string(std::string_view value) -> std::string_view
+    {
+        if (value.empty())
+        {
+            return {};
+        }
+        char* ptr = static_cast<char*>(allocate(value.size(), 1));
+        std::memcpy(ptr, value.data(), value.size());
+        return { ptr, value.size() };
+    }
+
+    template <class T>
+    auto store_value(const T& value) -> const T&
+    {
+        T* ptr = new (allocate(sizeof(T), alignof(T))) T(value);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            m_destructors.emplace_back([](void* p) { static_cast<T*>(p)->~T(); }, ptr);
+        }
+        return *ptr;
+    }
+};
+
+namespace detail
+{
+
+inline auto wrap_args(const dynamic_format_arg_store& store) -> const std::vector<arg_ref>&
+{
+    return store.args();
+}
+
+}  // namespace detail
+
+}  // namespace fmt
+}  // namespace ferrugo
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <algorithm>
+#include <ferrugo/fmt/stats.hpp>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <string>
 
 namespace ferrugo
 {
@@ -9,37 +13,73 @@ namespace ferrugo
 namespace fmt
 {
 
+/*
+ * Output buffer backed by std::basic_string, so that the formatted text can be moved out of it without copying.
+ * Growth only reserves the storage - the characters are written by append, never value-initialized first.
+ * A buffer constructed with a sink does not grow past its chunk size - instead its contents are passed to the sink,
+ * which keeps the memory usage constant regardless of the output size.
+ */
 template <class T>
 struct basic_buffer
 {
     using grow_function_type = std::size_t (*)(std::size_t);
-    std::size_t m_size;
-    std::size_t m_capacity;
+    using string_type = std::basic_string<T>;
+    using sink_type = std::function<void(const T*, std::size_t)>;
 
     grow_function_type m_grow_fn;
-    std::unique_ptr<T[]> m_data;
+    string_type m_data;
+    sink_type m_sink;
+    std::size_t m_chunk_size;
+    std::size_t m_flushed;
 
-    explicit basic_buffer(std::size_t capacity, grow_function_type grow_fn)
-        : m_size{ 0 }
-        , m_capacity{ capacity }
-        , m_grow_fn{ grow_fn }
-        , m_data{}
+    static std::size_t default_grow(std::size_t n)
     {
-        m_data.reset(new T[m_capacity]);
+        return 2 * n;
     }
 
-    explicit basic_buffer() : basic_buffer(64, [](std::size_t n) { return 2 * n; })
+    explicit basic_buffer(string_type data, grow_function_type grow_fn = &default_grow)
+        : m_grow_fn{ grow_fn }
+        , m_data{ std::move(data) }
+        , m_sink{}
+        , m_chunk_size{ 0 }
+        , m_flushed{ 0 }
     {
     }
 
+    explicit basic_buffer(std::size_t capacity, grow_function_type grow_fn) : basic_buffer(string_type{}, grow_fn)
+    {
+        m_data.reserve(capacity);
+    }
+
+    explicit basic_buffer() : basic_buffer(64, &default_grow)
+    {
+    }
+
+    explicit basic_buffer(std::size_t chunk_size, sink_type sink) : basic_buffer(string_type{})
+    {
+        m_sink = std::move(sink);
+        m_chunk_size = chunk_size;
+    }
+
     std::size_t size() const
     {
-        return m_size;
+        return m_data.size();
+    }
+
+    std::size_t capacity() const
+    {
+        return m_data.capacity();
+    }
+
+    // Number of elements written so far, including the ones already passed to the sink.
+    std::size_t written() const
+    {
+        return m_flushed + size();
     }
 
     const T* begin() const
     {
-        return m_data.get();
+        return m_data.data();
     }
 
     const T* end() const
@@ -49,7 +89,7 @@ struct basic_buffer
 
     T* begin()
     {
-        return m_data.get();
+        return m_data.data();
     }
 
     T* end()
@@ -59,29 +99,42 @@ struct basic_buffer
 
     void ensure_capacity(std::size_t required_capacity)
     {
-        if (required_capacity <= m_capacity)
+        if (required_capacity <= capacity())
         {
             return;
         }
 
-        std::size_t new_capacity = m_capacity;
+        std::size_t new_capacity = std::max<std::size_t>(capacity(), 1);
         while (new_capacity < required_capacity)
         {
             new_capacity = m_grow_fn(new_capacity);
         }
 
-        std::unique_ptr<T[]> ptr(new T[new_capacity]);
-        std::copy(begin(), end(), ptr.get());
-        m_data = std::move(ptr);
-        m_capacity = new_capacity;
+        FERRUGO_FMT_STATS_GROW();
+        m_data.reserve(new_capacity);
+    }
+
+    // Reserves room for `n` more elements; a buffer with a sink reserves at most its chunk size.
+    void ensure_free_capacity(std::size_t n)
+    {
+        ensure_capacity(m_sink ? std::min(size() + n, m_chunk_size) : size() + n);
     }
 
     void append(const T* b, const T* e)
     {
-        std::size_t s = std::distance(b, e);
-        ensure_capacity(size() + s);
-        std::copy(b, e, end());
-        m_size += s;
+        const std::size_t n = std::distance(b, e);
+        if (m_sink && size() + n > m_chunk_size)
+        {
+            flush();
+            if (n >= m_chunk_size)
+            {
+                m_sink(b, n);
+                m_flushed += n;
+                return;
+            }
+        }
+        ensure_capacity(size() + n);
+        m_data.append(b, e);
     }
 
     void append(const T* b, std::size_t n)
@@ -89,9 +142,45 @@ struct basic_buffer
         append(b, b + n);
     }
 
+    // Largest `n` for which `extend(n)` keeps a buffer with a sink within its chunk size.
+    std::size_t extend_limit() const
+    {
+        return m_sink ? std::max<std::size_t>(m_chunk_size, 1) : std::numeric_limits<std::size_t>::max();
+    }
+
+    // Grows the buffer by `n` elements and returns the pointer to the first of them. With a sink, callers writing
+    // large outputs should extend in pieces of at most `extend_limit()` elements to keep the memory usage constant.
+    T* extend(std::size_t n)
+    {
+        if (m_sink && size() + n > m_chunk_size)
+        {
+            flush();
+        }
+        ensure_capacity(size() + n);
+        m_data.resize(size() + n);
+        return end() - n;
+    }
+
     void reset()
     {
-        m_size = 0;
+        m_data.clear();
+    }
+
+    // Passes the contents to the sink (if any) and clears the buffer.
+    void flush()
+    {
+        if (m_sink && size() > 0)
+        {
+            m_sink(begin(), size());
+            m_flushed += size();
+            reset();
+        }
+    }
+
+    // Moves the contents out of the buffer.
+    string_type str() &&
+    {
+        return std::move(m_data);
     }
 };
 
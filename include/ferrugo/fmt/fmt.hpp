@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ferrugo/fmt/args.hpp>
 #include <ferrugo/fmt/format.hpp>
+#include <ferrugo/fmt/registry.hpp>
+#include <ferrugo/fmt/stats.hpp>
 #include <ferrugo/fmt/std.hpp>
-
@@ -1,19 +1,40 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <ferrugo/core/overloaded.hpp>
 #include <ferrugo/core/type_traits.hpp>
 #include <ferrugo/fmt/buffer.hpp>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <string_view>
 #include <variant>
 #include <vector>
 
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+// Wraps a string literal so that the format string is parsed and checked against the argument types at compile time.
+#define FERRUGO_FMT_STRING(s)                                                  \
+    [] {                                                                       \
+        struct str : ::ferrugo::fmt::detail::compile_time_string_tag           \
+        {                                                                      \
+            constexpr operator std::string_view() const                        \
+            {                                                                  \
+                return s;                                                      \
+            }                                                                  \
+        };                                                                     \
+        return str{};                                                          \
+    }()
+
 namespace ferrugo
 {
 namespace fmt
@@ -25,11 +46,11 @@ struct formatter;
 class parse_context
 {
 public:
-    explicit parse_context(std::string_view specifier) : m_specifier{ specifier }
+    constexpr explicit parse_context(std::string_view specifier) : m_specifier{ specifier }
     {
     }
 
-    std::string_view specifier() const
+    constexpr std::string_view specifier() const
     {
         return m_specifier;
     }
@@ -76,11 +97,67 @@ struct format_error : std::runtime_error
 namespace detail
 {
 
+template <class T, class = void>
+struct has_size_hint : std::false_type
+{
+};
+
+template <class T>
+struct has_size_hint<T, std::void_t<decltype(formatter<T>::size_hint(std::declval<const T&>()))>> : std::true_type
+{
+};
+
+// Estimated formatted size, as reported by the optional `formatter<T>::size_hint(const T&)`; 0 if unknown.
+template <class T>
+auto size_hint(const T& item) -> std::size_t
+{
+    if constexpr (has_size_hint<T>::value)
+    {
+        return formatter<T>::size_hint(item);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+template <class T>
+struct named_arg
+{
+    std::string_view m_name;
+    const T& m_value;
+};
+
+template <class T>
+struct is_named_arg : std::false_type
+{
+};
+
+template <class T>
+struct is_named_arg<named_arg<T>> : std::true_type
+{
+};
+
+template <class T>
+constexpr auto arg_name(const T&) -> std::string_view
+{
+    return {};
+}
+
+template <class T>
+constexpr auto arg_name(const named_arg<T>& item) -> std::string_view
+{
+    return item.m_name;
+}
+
 struct arg_ref
 {
     using arg_printer = void (*)(format_context&, const void*, const parse_context&);
+    using arg_size_hint = std::size_t (*)(const void*);
     arg_printer m_printer;
+    arg_size_hint m_size_hint;
     const void* m_ptr;
+    std::string_view m_name;
 
     template <class T>
     explicit arg_ref(const T& item)
@@ -90,7 +167,9 @@ struct arg_ref
                          f.parse(parse_ctx);
                          f.format(format_ctx, *static_cast<const T*>(ptr));
                      } }
+        , m_size_hint{ [](const void* ptr) { return detail::size_hint(*static_cast<const T*>(ptr)); } }
         , m_ptr{ std::addressof(item) }
+        , m_name{ arg_name(item) }
     {
     }
 
@@ -101,8 +180,30 @@ struct arg_ref
     {
         m_printer(format_ctx, m_ptr, parse_ctx);
     }
+
+    std::size_t size_hint() const
+    {
+        return m_size_hint(m_ptr);
+    }
+
+    std::string_view name() const
+    {
+        return m_name;
+    }
 };
 
+// Size hint of the argument printed by a replacement field; 0 if there is no such argument (formatting reports it).
+inline auto field_size_hint(const std::vector<arg_ref>& arguments, std::size_t index) -> std::size_t
+{
+    return index < arguments.size() ? arguments[index].size_hint() : 0;
+}
+
+// Size hint of the argument resolved for a named field.
+inline auto field_size_hint(const arg_ref* named) -> std::size_t
+{
+    return named ? named->size_hint() : 0;
+}
+
 template <class... Args>
 auto wrap_args(const Args&... args) -> std::vector<arg_ref>
 {
@@ -112,6 +213,338 @@ auto wrap_args(const Args&... args) -> std::vector<arg_ref>
     return result;
 }
 
+}  // namespace detail
+
+class dynamic_format_arg_store;
+
+namespace detail
+{
+
+// Uses the arguments held by the store (see args.hpp).
+inline auto wrap_args(const dynamic_format_arg_store& store) -> const std::vector<arg_ref>&;
+
+// Largest accepted argument index; larger ones are rejected before they can overflow `index + 1`.
+static constexpr inline std::size_t max_arg_index = std::numeric_limits<int>::max();
+
+constexpr auto parse_index(std::string_view txt) -> std::size_t
+{
+    std::size_t result = 0;
+    for (char c : txt)
+    {
+        if (!('0' <= c && c <= '9'))
+        {
+            throw format_error{ "invalid argument index" };
+        }
+        result = result * 10 + static_cast<std::size_t>(c - '0');
+        if (result > max_arg_index)
+        {
+            throw format_error{ "argument index too large" };
+        }
+    }
+    return result;
+}
+
+constexpr auto is_identifier(std::string_view txt) -> bool
+{
+    const auto is_alpha = [](char c) { return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_'; };
+    if (txt.empty() || !is_alpha(txt[0]))
+    {
+        return false;
+    }
+    for (char c : txt)
+    {
+        if (!is_alpha(c) && !('0' <= c && c <= '9'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Splits the format string into literal text and replacement fields, reporting them to the visitor's
+ * `text(std::string_view)`, `argument(std::size_t index, std::string_view specifier)`
+ * and `named_argument(std::string_view name, std::string_view specifier)` functions.
+ * Named fields do not advance the automatic index. Being constexpr, it is shared by the runtime parser and
+ * the compile-time checks.
+ */
+template <class Visitor>
+constexpr void parse_format_string(std::string_view fmt, Visitor& visitor)
+{
+    std::size_t arg_index = 0;
+    std::size_t text_begin = 0;
+    std::size_t pos = 0;
+    while (pos < fmt.size())
+    {
+        const char c = fmt[pos];
+        if (c != '{' && c != '}')
+        {
+            ++pos;
+            continue;
+        }
+        if (pos + 1 < fmt.size() && fmt[pos + 1] == c)
+        {
+            visitor.text(fmt.substr(text_begin, pos + 1 - text_begin));
+            pos += 2;
+            text_begin = pos;
+            continue;
+        }
+        if (c == '}')
+        {
+            throw format_error{ "unmatched closing bracket" };
+        }
+        const std::size_t closing_bracket = fmt.find('}', pos + 1);
+        if (closing_bracket == std::string_view::npos)
+        {
+            throw format_error{ "unclosed bracket" };
+        }
+        if (pos != text_begin)
+        {
+            visitor.text(fmt.substr(text_begin, pos - text_begin));
+        }
+        const std::string_view arg = fmt.substr(pos + 1, closing_bracket - pos - 1);
+        const std::size_t colon = arg.find(':');
+        const std::string_view index_part = arg.substr(0, colon);
+        const std::string_view fmt_part = colon != std::string_view::npos ? arg.substr(colon + 1) : std::string_view{};
+        if (is_identifier(index_part))
+        {
+            visitor.named_argument(index_part, fmt_part);
+        }
+        else
+        {
+            visitor.argument(!index_part.empty() ? parse_index(index_part) : arg_index, fmt_part);
+            ++arg_index;
+        }
+        pos = closing_bracket + 1;
+        text_begin = pos;
+    }
+    if (text_begin != fmt.size())
+    {
+        visitor.text(fmt.substr(text_begin));
+    }
+}
+
+// murmur3 finalizer: makes every bit of the result depend on every bit of `h`.
+constexpr auto mix_hash(std::uint32_t h) -> std::uint32_t
+{
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+constexpr auto hash_name(std::string_view name) -> std::uint32_t
+{
+    std::uint32_t result = 2166136261u;
+    for (char c : name)
+    {
+        result = (result ^ static_cast<std::uint8_t>(c)) * 16777619u;
+    }
+    return mix_hash(result);
+}
+
+static constexpr inline std::uint16_t no_slot = std::numeric_limits<std::uint16_t>::max();
+
+constexpr auto ceil_pow2(std::size_t n) -> std::size_t
+{
+    std::size_t result = 1;
+    while (result < n)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+/*
+ * Perfect hash of the names of the named fields, linear in their count (hash and displace): the names are distributed
+ * to buckets by their hash, and each bucket stores the seed which moves its names to free slots. The table consists of
+ * `name_bucket_count(n)` seeds followed by `name_slot_count(n)` slots - indices of the names or no_slot.
+ */
+constexpr auto name_bucket_count(std::size_t count) -> std::size_t
+{
+    return ceil_pow2((count + 1) / 2);
+}
+
+constexpr auto name_slot_count(std::size_t count) -> std::size_t
+{
+    return ceil_pow2(2 * count);
+}
+
+constexpr auto name_table_size(std::size_t count) -> std::size_t
+{
+    return name_bucket_count(count) + name_slot_count(count);
+}
+
+// Size of the working storage of build_name_table.
+constexpr auto name_scratch_size(std::size_t count) -> std::size_t
+{
+    return name_bucket_count(count) + count;
+}
+
+constexpr auto name_bucket(std::uint32_t hash, std::size_t bucket_count) -> std::size_t
+{
+    return hash & (bucket_count - 1);
+}
+
+constexpr auto name_slot(std::uint32_t hash, std::uint32_t seed, std::size_t slot_count) -> std::size_t
+{
+    return mix_hash(hash ^ (seed * 0x9E3779B9u)) & (slot_count - 1);
+}
+
+/*
+ * Fills the `table` (of name_table_size) for the (unique) `names`. The `scratch` (of name_scratch_size) holds the list
+ * of names of each bucket; the largest buckets are placed first, while most of the slots are free.
+ */
+template <class Names, class Table, class Scratch>
+constexpr void build_name_table(const Names& names, Table& table, Scratch& scratch)
+{
+    const std::size_t count = names.size();
+    const std::size_t bucket_count = name_bucket_count(count);
+    const std::size_t slot_count = name_slot_count(count);
+
+    // scratch[bucket] is the first name of the bucket, scratch[bucket_count + name] the next one in the same bucket.
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket)
+    {
+        scratch[bucket] = no_slot;
+        table[bucket] = 0;
+    }
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const std::size_t bucket = name_bucket(hash_name(names[index]), bucket_count);
+        scratch[bucket_count + index] = scratch[bucket];
+        scratch[bucket] = static_cast<std::uint16_t>(index);
+    }
+    for (std::size_t slot = 0; slot < slot_count; ++slot)
+    {
+        table[bucket_count + slot] = no_slot;
+    }
+
+    const auto bucket_size = [&](std::size_t bucket)
+    {
+        std::size_t result = 0;
+        for (std::uint16_t index = scratch[bucket]; index != no_slot; index = scratch[bucket_count + index])
+        {
+            ++result;
+        }
+        return result;
+    };
+
+    std::size_t max_size = 0;
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket)
+    {
+        max_size = std::max(max_size, bucket_size(bucket));
+    }
+
+    for (std::size_t size = max_size; size > 0; --size)
+    {
+        for (std::size_t bucket = 0; bucket < bucket_count; ++bucket)
+        {
+            if (bucket_size(bucket) != size)
+            {
+                continue;
+            }
+            for (std::uint32_t seed = 0;; ++seed)
+            {
+                if (seed == no_slot)
+                {
+                    throw format_error{ "cannot build the name table" };
+                }
+                std::uint16_t index = scratch[bucket];
+                for (; index != no_slot; index = scratch[bucket_count + index])
+                {
+                    auto& entry = table[bucket_count + name_slot(hash_name(names[index]), seed, slot_count)];
+                    if (entry != no_slot)
+                    {
+                        break;
+                    }
+                    entry = index;
+                }
+                if (index == no_slot)
+                {
+                    table[bucket] = static_cast<std::uint16_t>(seed);
+                    break;
+                }
+                // Undo the names placed before the collision.
+                for (std::uint16_t placed = scratch[bucket]; placed != index; placed = scratch[bucket_count + placed])
+                {
+                    table[bucket_count + name_slot(hash_name(names[placed]), seed, slot_count)] = no_slot;
+                }
+            }
+        }
+    }
+}
+
+// Index of `name` in the `names` of the `table`, or no_slot.
+template <class Names, class Table>
+constexpr auto find_name(const Names& names, const Table& table, std::string_view name) -> std::size_t
+{
+    const std::size_t bucket_count = name_bucket_count(names.size());
+    const std::uint32_t hash = hash_name(name);
+    const std::uint16_t seed = table[name_bucket(hash, bucket_count)];
+    const std::uint16_t index = table[bucket_count + name_slot(hash, seed, name_slot_count(names.size()))];
+    return index != no_slot && names[index] == name ? index : no_slot;
+}
+
+/*
+ * Maps the slots of the named fields to the named arguments, with one hash lookup per named argument. The slots without
+ * an argument are left null.
+ */
+template <class Names, class Table>
+void find_named_arguments(
+    const std::vector<arg_ref>& arguments, const Names& names, const Table& table, const arg_ref** slots)
+{
+    std::fill(slots, slots + names.size(), nullptr);
+    for (const arg_ref& arg : arguments)
+    {
+        if (arg.name().empty())
+        {
+            continue;
+        }
+        const std::size_t slot = find_name(names, table, arg.name());
+        if (slot != no_slot)
+        {
+            slots[slot] = &arg;
+        }
+    }
+}
+
+// As find_named_arguments, but every named field must have an argument.
+template <class Names, class Table>
+void resolve_named_arguments(
+    const std::vector<arg_ref>& arguments, const Names& names, const Table& table, const arg_ref** slots)
+{
+    find_named_arguments(arguments, names, table, slots);
+    for (std::size_t slot = 0; slot < names.size(); ++slot)
+    {
+        if (!slots[slot])
+        {
+            throw format_error{ "missing named argument '" + std::string{ names[slot] } + "'" };
+        }
+    }
+}
+
+// Formats directly into the string storage, reusing its capacity.
+template <class Fmt>
+void format_append(std::string& out, const Fmt& fmt, const std::vector<arg_ref>& arguments)
+{
+    const std::size_t size = out.size();
+    buffer buf{ std::move(out) };
+    try
+    {
+        format_context format_ctx{ buf };
+        fmt.format(format_ctx, arguments);
+    }
+    catch (...)
+    {
+        out = std::move(buf).str();
+        out.resize(size);
+        throw;
+    }
+    out = std::move(buf).str();
+}
+
 class format_string
 {
 private:
@@ -122,35 +555,106 @@ private:
 
     struct print_argument
     {
-        int index;
+        std::size_t index;
         parse_context context;
     };
 
-    using print_action = std::variant<print_text, print_argument>;
+    struct print_named_argument
+    {
+        std::size_t slot;
+        parse_context context;
+    };
+
+    using print_action = std::variant<print_text, print_argument, print_named_argument>;
 
 public:
-    explicit format_string(std::string_view fmt) : m_actions{ parse(fmt) }
+    explicit format_string(std::string_view fmt)
+        : m_text{ fmt }
+        , m_actions{}
+        , m_arg_count{ 0 }
+        , m_text_size{ 0 }
+        , m_names{}
+        , m_name_table{}
     {
+        struct visitor
+        {
+            format_string& self;
+
+            void text(std::string_view txt)
+            {
+                self.m_actions.push_back(print_text{ txt });
+                self.m_text_size += txt.size();
+            }
+
+            void argument(std::size_t index, std::string_view specifier)
+            {
+                self.m_actions.push_back(print_argument{ index, parse_context{ specifier } });
+                self.m_arg_count = std::max(self.m_arg_count, index + 1);
+            }
+
+            void named_argument(std::string_view name, std::string_view specifier)
+            {
+                auto& names = self.m_names;
+                const std::size_t slot = std::find(names.begin(), names.end(), name) - names.begin();
+                if (slot == names.size())
+                {
+                    names.push_back(name);
+                }
+                self.m_actions.push_back(print_named_argument{ slot, parse_context{ specifier } });
+            }
+        };
+        visitor v{ *this };
+        parse_format_string(fmt, v);
+        if (m_names.size() >= no_slot)
+        {
+            throw format_error{ "too many named arguments" };
+        }
+        m_name_table.resize(name_table_size(m_names.size()));
+        std::vector<std::uint16_t> scratch(name_scratch_size(m_names.size()));
+        build_name_table(m_names, m_name_table, scratch);
     }
 
     void format(format_context& format_ctx, const std::vector<arg_ref>& arguments) const
     {
+        FERRUGO_FMT_STATS_SCOPE(m_text, format_ctx.output());
+        if (arguments.size() < m_arg_count)
+        {
+            throw format_error{ "argument index out of range" };
+        }
+        std::vector<const arg_ref*> named(m_names.size());
+        if (!m_names.empty())
+        {
+            resolve_named_arguments(arguments, m_names, m_name_table, named.data());
+        }
+        format_ctx.output().ensure_free_capacity(size_hint(arguments, named.data()));
         for (const auto& action : m_actions)
         {
             std::visit(
                 ferrugo::core::overloaded{ [&](const print_text& a) { write_to(format_ctx, a.text); },
                                            [&](const print_argument& a)
-                                           { arguments.at(a.index).print(format_ctx, a.context); } },
+                                           { arguments[a.index].print(format_ctx, a.context); },
+                                           [&](const print_named_argument& a)
+                                           { named[a.slot]->print(format_ctx, a.context); } },
                 action);
         }
     }
 
     auto format(const std::vector<arg_ref>& arguments) const -> std::string
     {
-        buffer buf{};
-        format_context format_ctx{ buf };
-        format(format_ctx, arguments);
-        return std::string(buf.begin(), buf.end());
+        std::string result;
+        format_append(result, *this, arguments);
+        return result;
+    }
+
+    // Estimated size of the output: the length of the literal text plus the size hint of every replacement field.
+    std::size_t size_hint(const std::vector<arg_ref>& arguments) const
+    {
+        std::vector<const arg_ref*> named(m_names.size());
+        if (!m_names.empty())
+        {
+            find_named_arguments(arguments, m_names, m_name_table, named.data());
+        }
+        return size_hint(arguments, named.data());
     }
 
     friend std::ostream& operator<<(std::ostream& os, const format_string& item)
@@ -169,6 +673,15 @@ public:
                                                {
                                                    os << "{" << a.index << ":" << a.context.specifier() << "}";
                                                }
+                                           },
+                                           [&](const print_named_argument& a)
+                                           {
+                                               os << "{" << item.m_names[a.slot];
+                                               if (!a.context.specifier().empty())
+                                               {
+                                                   os << ":" << a.context.specifier();
+                                               }
+                                               os << "}";
                                            } },
                 action);
         }
@@ -176,99 +689,315 @@ public:
     }
 
 private:
+    std::string_view m_text;
     std::vector<print_action> m_actions;
+    std::size_t m_arg_count;
+    std::size_t m_text_size;
+    std::vector<std::string_view> m_names;
+    std::vector<std::uint16_t> m_name_table;
+
+    std::size_t size_hint(const std::vector<arg_ref>& arguments, const arg_ref* const* named) const
+    {
+        std::size_t result = m_text_size;
+        for (const auto& action : m_actions)
+        {
+            if (const auto* arg = std::get_if<print_argument>(&action))
+            {
+                result += field_size_hint(arguments, arg->index);
+            }
+            else if (const auto* field = std::get_if<print_named_argument>(&action))
+            {
+                result += field_size_hint(named[field->slot]);
+            }
+        }
+        return result;
+    }
+};
+
+struct compile_time_string_tag
+{
+};
+
+template <class S>
+constexpr bool is_compile_time_string_v = std::is_base_of_v<compile_time_string_tag, S>;
+
+// Specialized for pre-parsed layouts which provide the format_string interface (see registry.hpp).
+template <class T>
+struct is_format_layout : std::false_type
+{
+};
+
+template <class T>
+constexpr bool is_format_layout_v = is_format_layout<T>::value;
+
+template <class T, class = void>
+struct has_check_specifier : std::false_type
+{
+};
+
+template <class T>
+struct has_check_specifier<T, std::void_t<decltype(T::check_specifier(std::string_view{}))>> : std::true_type
+{
+};
+
+using specifier_checker = void (*)(std::string_view);
+
+template <class T>
+constexpr void check_specifier(std::string_view specifier)
+{
+    if constexpr (has_check_specifier<formatter<T>>::value)
+    {
+        formatter<T>::check_specifier(specifier);
+    }
+}
+
+/*
+ * Format string known at compile time (see FERRUGO_FMT_STRING). Its layout is parsed into a constexpr table of actions,
+ * and `check<Args...>()` validates the argument indices and - for formatters providing a constexpr
+ * `check_specifier(std::string_view)` - the format specifiers, so that errors are reported during compilation.
+ */
+template <class S>
+class static_format_string
+{
+private:
+    enum class action_kind
+    {
+        text,
+        argument,
+        named_argument
+    };
+
+    struct action
+    {
+        action_kind kind;
+        std::size_t index;
+        std::string_view name;
+        std::string_view text;
+    };
+
+    struct counter
+    {
+        std::size_t count = 0;
+        std::size_t arg_count = 0;
+        std::size_t text_size = 0;
+
+        constexpr void text(std::string_view txt)
+        {
+            ++count;
+            text_size += txt.size();
+        }
+
+        constexpr void argument(std::size_t index, std::string_view)
+        {
+            ++count;
+            arg_count = std::max(arg_count, index + 1);
+        }
+
+        constexpr void named_argument(std::string_view, std::string_view)
+        {
+            ++count;
+        }
+    };
+
+    template <std::size_t N>
+    struct collector
+    {
+        std::array<action, N> actions = {};
+        std::size_t count = 0;
+        std::size_t name_count = 0;
+
+        constexpr void text(std::string_view txt)
+        {
+            actions[count++] = action{ action_kind::text, 0, {}, txt };
+        }
+
+        constexpr void argument(std::size_t index, std::string_view specifier)
+        {
+            actions[count++] = action{ action_kind::argument, index, {}, specifier };
+        }
+
+        constexpr void named_argument(std::string_view name, std::string_view specifier)
+        {
+            std::size_t slot = 0;
+            while (slot < count && !(actions[slot].kind == action_kind::named_argument && actions[slot].name == name))
+            {
+                ++slot;
+            }
+            const std::size_t index = slot < count ? actions[slot].index : name_count++;
+            actions[count++] = action{ action_kind::named_argument, index, name, specifier };
+        }
+    };
+
+    template <std::size_t N>
+    struct name_table
+    {
+        std::array<std::string_view, N> names = {};
+        std::array<std::uint16_t, name_table_size(N)> table = {};
+    };
+
+    static constexpr std::string_view fmt = S{};
+
+    static constexpr counter stats = []()
+    {
+        counter c{};
+        parse_format_string(fmt, c);
+        return c;
+    }();
+
+    static constexpr collector<stats.count> layout = []()
+    {
+        collector<stats.count> c{};
+        parse_format_string(fmt, c);
+        return c;
+    }();
+
+    static constexpr const std::array<action, stats.count>& actions = layout.actions;
+
+    static constexpr name_table<layout.name_count> names = []()
+    {
+        name_table<layout.name_count> result{};
+        for (const action& a : actions)
+        {
+            if (a.kind == action_kind::named_argument)
+            {
+                result.names[a.index] = a.name;
+            }
+        }
+        std::array<std::uint16_t, name_scratch_size(layout.name_count)> scratch = {};
+        build_name_table(result.names, result.table, scratch);
+        return result;
+    }();
 
-    static auto parse(std::string_view fmt) -> std::vector<print_action>
+    static std::size_t size_hint(const std::vector<arg_ref>& arguments, const arg_ref* const* named)
     {
-        static const auto is_opening_bracket = [](char c) { return c == '{'; };
-        static const auto is_closing_bracket = [](char c) { return c == '}'; };
-        static const auto is_bracket = [](char c) { return is_opening_bracket(c) || is_closing_bracket(c); };
-        static const auto is_colon = [](char c) { return c == ':'; };
-        std::vector<print_action> result;
-        int arg_index = 0;
-        while (!fmt.empty())
+        std::size_t result = stats.text_size;
+        for (const action& a : actions)
         {
-            const auto begin = std::begin(fmt);
-            const auto end = std::end(fmt);
-            const auto bracket = std::find_if(begin, end, is_bracket);
-            if (bracket == end)
+            switch (a.kind)
             {
-                result.push_back(print_text{ fmt });
-                fmt = make_string_view(bracket, end);
+                case action_kind::text: break;
+                case action_kind::argument: result += field_size_hint(arguments, a.index); break;
+                case action_kind::named_argument: result += field_size_hint(named[a.index]); break;
             }
-            else if (bracket[0] == bracket[1])
+        }
+        return result;
+    }
+
+public:
+    template <class... Args>
+    static constexpr bool check()
+    {
+        constexpr specifier_checker checkers[] = { &check_specifier<Args>..., nullptr };
+        if (stats.arg_count > sizeof...(Args))
+        {
+            throw format_error{ "argument index out of range" };
+        }
+        if (layout.name_count > 0 && !(is_named_arg<Args>::value || ...))
+        {
+            throw format_error{ "named field without named arguments" };
+        }
+        for (const action& a : actions)
+        {
+            if (a.kind == action_kind::argument)
             {
-                result.push_back(print_text{ make_string_view(begin, bracket + 1) });
-                fmt = make_string_view(bracket + 2, end);
+                checkers[a.index](a.text);
             }
-            else if (is_opening_bracket(bracket[0]))
-            {
-                const auto closing_bracket = std::find_if(bracket + 1, end, is_closing_bracket);
-                if (closing_bracket == end)
-                {
-                    throw format_error{ "unclosed bracket" };
-                }
-                result.push_back(print_text{ make_string_view(begin, bracket) });
+        }
+        return true;
+    }
 
-                const auto [actual_index, fmt_specifer] = std::invoke(
-                    [](std::string_view arg, int current_index) -> std::tuple<int, std::string_view>
-                    {
-                        const auto colon = std::find_if(std::begin(arg), std::end(arg), is_colon);
-                        const auto index_part = make_string_view(std::begin(arg), colon);
-                        const auto fmt_part = make_string_view(colon != std::end(arg) ? colon + 1 : colon, std::end(arg));
-                        const auto index = !index_part.empty() ? parse_int(index_part) : current_index;
-                        return { index, fmt_part };
-                    },
-                    make_string_view(bracket + 1, closing_bracket),
-                    arg_index);
-                result.push_back(print_argument{ actual_index, parse_context{ fmt_specifer } });
-                fmt = make_string_view(closing_bracket + 1, end);
-                ++arg_index;
+    static void format(format_context& format_ctx, const std::vector<arg_ref>& arguments)
+    {
+        FERRUGO_FMT_STATS_SCOPE(fmt, format_ctx.output());
+        // Checked at compile time, except for runtime argument lists (dynamic_format_arg_store).
+        if (arguments.size() < stats.arg_count)
+        {
+            throw format_error{ "argument index out of range" };
+        }
+        std::array<const arg_ref*, layout.name_count> named = {};
+        if constexpr (layout.name_count > 0)
+        {
+            resolve_named_arguments(arguments, names.names, names.table, named.data());
+        }
+        format_ctx.output().ensure_free_capacity(size_hint(arguments, named.data()));
+        for (const action& a : actions)
+        {
+            switch (a.kind)
+            {
+                case action_kind::text: format_ctx.output().append(a.text.data(), a.text.size()); break;
+                case action_kind::argument: arguments[a.index].print(format_ctx, parse_context{ a.text }); break;
+                case action_kind::named_argument: named[a.index]->print(format_ctx, parse_context{ a.text }); break;
             }
         }
-        return result;
     }
 
-    static auto make_string_view(std::string_view::iterator b, std::string_view::iterator e) -> std::string_view
+    static auto format(const std::vector<arg_ref>& arguments) -> std::string
     {
-        if (b < e)
-            return { std::addressof(*b), std::string_view::size_type(e - b) };
-        else
-            return {};
+        std::string result;
+        format_append(result, static_format_string{}, arguments);
+        return result;
     }
 
-    static auto parse_int(std::string_view txt) -> int
+    static std::size_t size_hint(const std::vector<arg_ref>& arguments)
     {
-        int result = 0;
-        for (char c : txt)
+        std::array<const arg_ref*, layout.name_count> named = {};
+        if constexpr (layout.name_count > 0)
         {
-            assert('0' <= c && c <= '9');
-            result = result * 10 + (c - '0');
+            find_named_arguments(arguments, names.names, names.table, named.data());
         }
-        return result;
+        return size_hint(arguments, named.data());
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const static_format_string&)
+    {
+        return os << format_string{ fmt };
     }
 };
 
+template <class Fmt, class... Args>
+constexpr bool check_format_string()
+{
+    if constexpr (
+        is_compile_time_string_v<Fmt>
+        && !(std::is_same_v<std::remove_cv_t<std::remove_reference_t<Args>>, dynamic_format_arg_store> || ...))
+    {
+        static_assert(static_format_string<Fmt>::template check<std::remove_cv_t<std::remove_reference_t<Args>>...>());
+    }
+    return true;
+}
+
+template <class Fmt>
+using format_string_t = std::conditional_t<
+    is_compile_time_string_v<Fmt>,
+    static_format_string<Fmt>,
+    std::conditional_t<is_format_layout_v<Fmt>, Fmt, format_string>>;
+
+// Output is passed to the stream (or sink) in chunks of this size, so that printing needs constant memory.
+static constexpr inline std::size_t default_chunk_size = 64 * 1024;
+
 template <bool NewLine = false>
 struct print_to_fn
 {
+    template <class Fmt>
     struct impl
     {
         std::ostream& m_os;
-        format_string m_formatter;
+        format_string_t<Fmt> m_formatter;
 
         template <class... Args>
         void operator()(Args&&... args) const
         {
-            buffer buf{};
+            static_assert(check_format_string<Fmt, Args...>());
+            const auto& arguments = wrap_args(std::forward<Args>(args)...);
+            buffer buf{ default_chunk_size, [this](const char* data, std::size_t size) { m_os.write(data, size); } };
             format_context format_ctx{ buf };
-            m_formatter.format(format_ctx, wrap_args(std::forward<Args>(args)...));
+            m_formatter.format(format_ctx, arguments);
             if constexpr (NewLine)
             {
                 write_to(format_ctx, '\n');
             }
 
-            format_ctx.flush(m_os);
+            buf.flush();
         }
 
         friend std::ostream& operator<<(std::ostream& os, const impl& item)
@@ -277,26 +1006,52 @@ struct print_to_fn
         }
     };
 
-    auto operator()(std::ostream& os, std::string_view fmt) const -> impl
+    auto operator()(std::ostream& os, std::string_view fmt) const -> impl<std::string_view>
+    {
+        return impl<std::string_view>{ os, format_string{ fmt } };
+    }
+
+    auto operator()(std::string_view fmt) const -> impl<std::string_view>
+    {
+        return impl<std::string_view>{ std::cout, format_string{ fmt } };
+    }
+
+    template <class S, class = std::enable_if_t<is_compile_time_string_v<S>>>
+    auto operator()(std::ostream& os, S) const -> impl<S>
     {
-        return impl{ os, format_string{ fmt } };
+        return impl<S>{ os, {} };
     }
 
-    auto operator()(std::string_view fmt) const -> impl
+    template <class S, class = std::enable_if_t<is_compile_time_string_v<S>>>
+    auto operator()(S) const -> impl<S>
     {
-        return impl{ std::cout, format_string{ fmt } };
+        return impl<S>{ std::cout, {} };
+    }
+
+    template <class L, class = std::enable_if_t<is_format_layout_v<L>>>
+    auto operator()(std::ostream& os, const L& layout) const -> impl<L>
+    {
+        return impl<L>{ os, layout };
+    }
+
+    template <class L, class = std::enable_if_t<is_format_layout_v<L>>>
+    auto operator()(const L& layout) const -> impl<L>
+    {
+        return impl<L>{ std::cout, layout };
     }
 };
 
 struct format_fn
 {
+    template <class Fmt>
     struct impl
     {
-        format_string m_formatter;
+        format_string_t<Fmt> m_formatter;
 
         template <class... Args>
         auto operator()(Args&&... args) const -> std::string
         {
+            static_assert(check_format_string<Fmt, Args...>());
             return m_formatter.format(wrap_args(std::forward<Args>(args)...));
         }
 
@@ -306,9 +1061,120 @@ struct format_fn
         }
     };
 
-    auto operator()(std::string_view fmt) const -> impl
+    auto operator()(std::string_view fmt) const -> impl<std::string_view>
+    {
+        return impl<std::string_view>{ format_string{ fmt } };
+    }
+
+    template <class S, class = std::enable_if_t<is_compile_time_string_v<S>>>
+    auto operator()(S) const -> impl<S>
+    {
+        return impl<S>{};
+    }
+
+    template <class L, class = std::enable_if_t<is_format_layout_v<L>>>
+    auto operator()(const L& layout) const -> impl<L>
+    {
+        return impl<L>{ layout };
+    }
+};
+
+struct format_append_fn
+{
+    template <class Fmt>
+    struct impl
+    {
+        std::string& m_out;
+        format_string_t<Fmt> m_formatter;
+
+        template <class... Args>
+        auto operator()(Args&&... args) const -> std::string&
+        {
+            static_assert(check_format_string<Fmt, Args...>());
+            format_append(m_out, m_formatter, wrap_args(std::forward<Args>(args)...));
+            return m_out;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const impl& item)
+        {
+            return os << item.m_formatter;
+        }
+    };
+
+    auto operator()(std::string& out, std::string_view fmt) const -> impl<std::string_view>
+    {
+        return impl<std::string_view>{ out, format_string{ fmt } };
+    }
+
+    template <class S, class = std::enable_if_t<is_compile_time_string_v<S>>>
+    auto operator()(std::string& out, S) const -> impl<S>
+    {
+        return impl<S>{ out, {} };
+    }
+
+    template <class L, class = std::enable_if_t<is_format_layout_v<L>>>
+    auto operator()(std::string& out, const L& layout) const -> impl<L>
+    {
+        return impl<L>{ out, layout };
+    }
+};
+
+/*
+ * Streams the formatted output to `sink`, called with std::string_view chunks of at most `chunk_size` characters
+ * (longer pieces written by a single formatter are passed as they are).
+ */
+struct format_chunked_fn
+{
+    template <class Fmt>
+    struct impl
+    {
+        std::function<void(std::string_view)> m_sink;
+        format_string_t<Fmt> m_formatter;
+        std::size_t m_chunk_size;
+
+        template <class... Args>
+        void operator()(Args&&... args) const
+        {
+            static_assert(check_format_string<Fmt, Args...>());
+            const auto& arguments = wrap_args(std::forward<Args>(args)...);
+            buffer buf{ m_chunk_size, [this](const char* data, std::size_t size) { m_sink(std::string_view{ data, size }); } };
+            format_context format_ctx{ buf };
+            m_formatter.format(format_ctx, arguments);
+            buf.flush();
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const impl& item)
+        {
+            return os << item.m_formatter;
+        }
+    };
+
+    template <class Sink>
+    auto operator()(Sink sink, std::string_view fmt, std::size_t chunk_size = default_chunk_size) const
+        -> impl<std::string_view>
+    {
+        return impl<std::string_view>{ std::move(sink), format_string{ fmt }, chunk_size };
+    }
+
+    template <class Sink, class S, class = std::enable_if_t<is_compile_time_string_v<S>>>
+    auto operator()(Sink sink, S, std::size_t chunk_size = default_chunk_size) const -> impl<S>
+    {
+        return impl<S>{ std::move(sink), {}, chunk_size };
+    }
+
+    template <class Sink, class L, class = std::enable_if_t<is_format_layout_v<L>>>
+    auto operator()(Sink sink, const L& layout, std::size_t chunk_size = default_chunk_size) const -> impl<L>
+    {
+        return impl<L>{ std::move(sink), layout, chunk_size };
+    }
+};
+
+struct arg_fn
+{
+    template <class T>
+    auto operator()(std::string_view name, const T& value) const -> named_arg<T>
     {
-        return impl{ format_string{ fmt } };
+        return named_arg<T>{ name, value };
     }
 };
 
@@ -329,6 +1195,56 @@ struct join_fn
     }
 };
 
+struct hex_fn
+{
+    struct impl
+    {
+        const std::uint8_t* m_data;
+        std::size_t m_size;
+    };
+
+    auto operator()(const void* data, std::size_t size) const -> impl
+    {
+        return impl{ static_cast<const std::uint8_t*>(data), size };
+    }
+
+    template <class Range>
+    auto operator()(const Range& range) const -> impl
+    {
+        static_assert(sizeof(*std::data(range)) == 1, "hex requires a contiguous range of bytes");
+        return (*this)(std::data(range), std::size(range));
+    }
+
+    // String literals, without the terminating null character.
+    template <std::size_t N>
+    auto operator()(const char (&text)[N]) const -> impl
+    {
+        return (*this)(text, N - 1);
+    }
+};
+
+// Writes 2 * `size` hex digits to `out`.
+inline void write_hex(char* out, const std::uint8_t* data, std::size_t size, const char* digits)
+{
+#if defined(__SSSE3__)
+    const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+    for (; size >= 16; size -= 16, data += 16, out += 32)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        const __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble));
+        const __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(bytes, low_nibble));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+    for (; size > 0; --size, ++data)
+    {
+        *out++ = digits[*data >> 4];
+        *out++ = digits[*data & 0x0F];
+    }
+}
+
 }  // namespace detail
 
 template <class T>
@@ -359,53 +1275,152 @@ struct sprintf_formatter
     {
         static const char fmt[] = { '%', Fmt..., '\0' };
         char buffer[64];
-        int chars_written = std::sprintf(buffer, fmt, item);
-        ctx.output().append(buffer, chars_written);
+        const int chars_written = std::snprintf(buffer, sizeof(buffer), fmt, item);
+        if (chars_written < 0)
+        {
+            throw format_error{ "formatting failed" };
+        }
+        if (static_cast<std::size_t>(chars_written) < sizeof(buffer))
+        {
+            ctx.output().append(buffer, chars_written);
+            return;
+        }
+        // Large values in fixed notation, e.g. 1e300 with `%f`, need up to several thousand characters.
+        std::string large(static_cast<std::size_t>(chars_written) + 1, '\0');
+        std::snprintf(large.data(), large.size(), fmt, item);
+        ctx.output().append(large.data(), chars_written);
     }
 };
 
-template <class T>
-struct formatter<T, std::enable_if_t<std::is_integral_v<T>>>
+namespace detail
 {
-    void parse(const parse_context&)
+
+static constexpr inline char lower_digits[] = "0123456789abcdef";
+static constexpr inline char upper_digits[] = "0123456789ABCDEF";
+
+static constexpr inline char digit_pairs[] = "00010203040506070809"
+                                             "10111213141516171819"
+                                             "20212223242526272829"
+                                             "30313233343536373839"
+                                             "40414243444546474849"
+                                             "50515253545556575859"
+                                             "60616263646566676869"
+                                             "70717273747576777879"
+                                             "80818283848586878889"
+                                             "90919293949596979899";
+
+// Writes the digits backwards, ending at `end`; returns the pointer to the first digit.
+template <class U>
+auto write_decimal(char* end, U value) -> char*
+{
+    while (value >= 100)
     {
+        const auto pair = static_cast<std::size_t>(value % 100) * 2;
+        value /= 100;
+        *--end = digit_pairs[pair + 1];
+        *--end = digit_pairs[pair];
     }
-
-    void format(format_context& ctx, T item) const
+    if (value >= 10)
     {
-        const std::string s = std::to_string(item);
-        ctx.output().append(s.data(), s.size());
+        const auto pair = static_cast<std::size_t>(value) * 2;
+        *--end = digit_pairs[pair + 1];
+        *--end = digit_pairs[pair];
     }
-};
+    else
+    {
+        *--end = static_cast<char>('0' + value);
+    }
+    return end;
+}
 
-template <>
-struct formatter<int> : sprintf_formatter<'d'>
+template <unsigned Bits, class U>
+auto write_power_of_two(char* end, U value, const char* digits) -> char*
 {
-};
+    constexpr U mask = (U{ 1 } << Bits) - 1;
+    do
+    {
+        *--end = digits[value & mask];
+        value >>= Bits;
+    } while (value != 0);
+    return end;
+}
 
-template <>
-struct formatter<long> : sprintf_formatter<'l', 'd'>
-{
-};
+}  // namespace detail
 
-template <>
-struct formatter<long long> : sprintf_formatter<'l', 'l', 'd'>
+/*
+ * Integral formatter. Supported specifiers: `d` (default), `x`, `X`, `b` and `o`, optionally preceded by `#`
+ * which adds the base prefix (`0x`, `0X`, `0b` and `0` respectively).
+ */
+template <class T>
+struct formatter<T, std::enable_if_t<std::is_integral_v<T>>>
 {
-};
+    char m_type = 'd';
+    bool m_alternate = false;
 
-template <>
-struct formatter<unsigned> : sprintf_formatter<'u'>
-{
-};
+    static constexpr void check_specifier(std::string_view spec)
+    {
+        if (!spec.empty() && spec.front() == '#')
+        {
+            spec.remove_prefix(1);
+        }
+        if (spec.size() > 1 || (spec.size() == 1 && std::string_view{ "dxXbo" }.find(spec[0]) == std::string_view::npos))
+        {
+            throw format_error{ "invalid integer format specifier" };
+        }
+    }
 
-template <>
-struct formatter<unsigned long> : sprintf_formatter<'l', 'u'>
-{
-};
+    void parse(const parse_context& ctx)
+    {
+        std::string_view spec = ctx.specifier();
+        check_specifier(spec);
+        if (!spec.empty() && spec.front() == '#')
+        {
+            m_alternate = true;
+            spec.remove_prefix(1);
+        }
+        if (!spec.empty())
+        {
+            m_type = spec[0];
+        }
+    }
 
-template <>
-struct formatter<unsigned long long> : sprintf_formatter<'l', 'l', 'u'>
-{
+    // Decimal digits and sign; other presentations may exceed it.
+    static constexpr std::size_t size_hint(T)
+    {
+        return std::numeric_limits<T>::digits10 + 2;
+    }
+
+    void format(format_context& ctx, T item) const
+    {
+        using U = std::make_unsigned_t<T>;
+        const bool negative = item < T{};
+        const U value = negative ? static_cast<U>(U{} - static_cast<U>(item)) : static_cast<U>(item);
+
+        char buffer[std::numeric_limits<U>::digits + 3];
+        char* const end = buffer + sizeof(buffer);
+        char* ptr = end;
+        switch (m_type)
+        {
+            case 'x': ptr = detail::write_power_of_two<4>(ptr, value, detail::lower_digits); break;
+            case 'X': ptr = detail::write_power_of_two<4>(ptr, value, detail::upper_digits); break;
+            case 'b': ptr = detail::write_power_of_two<1>(ptr, value, detail::lower_digits); break;
+            case 'o': ptr = detail::write_power_of_two<3>(ptr, value, detail::lower_digits); break;
+            default: ptr = detail::write_decimal(ptr, value); break;
+        }
+        if (m_alternate && m_type != 'd' && !(m_type == 'o' && *ptr == '0'))
+        {
+            if (m_type != 'o')
+            {
+                *--ptr = m_type;
+            }
+            *--ptr = '0';
+        }
+        if (negative)
+        {
+            *--ptr = '-';
+        }
+        ctx.output().append(ptr, end);
+    }
 };
 
 template <>
@@ -430,6 +1445,11 @@ struct formatter<std::string>
     {
     }
 
+    static std::size_t size_hint(const std::string& item)
+    {
+        return item.size();
+    }
+
     void format(format_context& ctx, const std::string& item) const
     {
         ctx.output().append(item.data(), item.size());
@@ -443,6 +1463,11 @@ struct formatter<std::string_view>
     {
     }
 
+    static std::size_t size_hint(std::string_view item)
+    {
+        return item.size();
+    }
+
     void format(format_context& ctx, std::string_view item) const
     {
         ctx.output().append(item.data(), item.size());
@@ -456,6 +1481,11 @@ struct formatter<const char*>
     {
     }
 
+    static std::size_t size_hint(const char* item)
+    {
+        return std::strlen(item);
+    }
+
     void format(format_context& ctx, const char* item) const
     {
         ctx.output().append(item, std::strlen(item));
@@ -469,6 +1499,11 @@ struct formatter<char>
     {
     }
 
+    static constexpr std::size_t size_hint(char)
+    {
+        return 1;
+    }
+
     void format(format_context& ctx, const char item) const
     {
         ctx.output().append(&item, 1);
@@ -482,6 +1517,11 @@ struct formatter<char[N]>
     {
     }
 
+    static constexpr std::size_t size_hint(const char (&)[N])
+    {
+        return N - 1;
+    }
+
     void format(format_context& ctx, const char (&item)[N]) const
     {
         ctx.output().append(item, N - 1);
@@ -495,6 +1535,11 @@ struct formatter<bool>
     {
     }
 
+    static constexpr std::size_t size_hint(bool)
+    {
+        return 5;
+    }
+
     void format(format_context& ctx, bool item) const
     {
         if (item)
@@ -531,12 +1576,79 @@ struct formatter<detail::join_fn::impl<Iter>>
     }
 };
 
+/*
+ * Formats a contiguous block of bytes as hex digits; use `X` specifier for upper case.
+ */
+template <>
+struct formatter<detail::hex_fn::impl>
+{
+    const char* m_digits = detail::lower_digits;
+
+    void parse(const parse_context& ctx)
+    {
+        if (ctx.specifier() == "X")
+        {
+            m_digits = detail::upper_digits;
+        }
+        else if (!ctx.specifier().empty() && ctx.specifier() != "x")
+        {
+            throw format_error{ "invalid hex format specifier" };
+        }
+    }
+
+    static constexpr std::size_t size_hint(const detail::hex_fn::impl& item)
+    {
+        return 2 * item.m_size;
+    }
+
+    void format(format_context& ctx, const detail::hex_fn::impl& item) const
+    {
+        // Written in pieces, so that a chunked buffer does not have to hold the whole output.
+        const std::size_t piece = std::max<std::size_t>(ctx.output().extend_limit() / 2, 1);
+        for (std::size_t offset = 0; offset < item.m_size; offset += piece)
+        {
+            const std::size_t size = std::min(piece, item.m_size - offset);
+            detail::write_hex(ctx.output().extend(2 * size), item.m_data + offset, size, m_digits);
+        }
+    }
+};
+
+template <class T>
+struct formatter<detail::named_arg<T>>
+{
+    formatter<T> m_inner = {};
+
+    static constexpr void check_specifier(std::string_view spec)
+    {
+        detail::check_specifier<T>(spec);
+    }
+
+    static std::size_t size_hint(const detail::named_arg<T>& item)
+    {
+        return detail::size_hint(item.m_value);
+    }
+
+    void parse(const parse_context& ctx)
+    {
+        m_inner.parse(ctx);
+    }
+
+    void format(format_context& ctx, const detail::named_arg<T>& item) const
+    {
+        m_inner.format(ctx, item.m_value);
+    }
+};
+
+static constexpr inline auto arg = detail::arg_fn{};
 static constexpr inline auto join = detail::join_fn{};
+static constexpr inline auto hex = detail::hex_fn{};
 
 static constexpr inline auto print = detail::print_to_fn<>{};
 static constexpr inline auto println = detail::print_to_fn<true>{};
 
 static constexpr inline auto format = detail::format_fn{};
+static constexpr inline auto format_append = detail::format_append_fn{};
+static constexpr inline auto format_chunked = detail::format_chunked_fn{};
 
 }  // namespace fmt
 
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <ferrugo/fmt/format.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ferrugo
+{
+
+namespace fmt
+{
+
+namespace detail
+{
+
+/*
+ * Flat layout of the compiled templates. All the sections consist of 32-bit words (except for the hash tables and
+ * the character pool) and refer to each other by indices, so the data can be used in place, e.g. from a mapped file:
+ *
+ *   layout_header
+ *   layout_template[template_count]  - sorted by key
+ *   layout_action[action_count]
+ *   layout_string[name_count]
+ *   std::uint16_t[table_size]        - perfect hash tables of the names, padded to 4 bytes
+ *   char[pool_size]                  - keys and template texts
+ *
+ * The words are stored in the byte order of the host which compiled them; data written on a host of the other
+ * endianness is rejected by the magic check.
+ */
+struct layout_header
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t template_count;
+    std::uint32_t action_count;
+    std::uint32_t name_count;
+    std::uint32_t table_size;
+    std::uint32_t pool_size;
+    std::uint32_t reserved;
+};
+
+struct layout_string
+{
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct layout_template
+{
+    layout_string key;
+    layout_string text;
+    std::uint32_t first_action;
+    std::uint32_t action_count;
+    std::uint32_t arg_count;
+    std::uint32_t literal_size;
+    std::uint32_t first_name;
+    std::uint32_t name_count;
+    std::uint32_t first_table;
+    std::uint32_t table_size;
+};
+
+struct layout_action
+{
+    enum : std::uint32_t
+    {
+        text,
+        argument,
+        named_argument
+    };
+
+    std::uint32_t kind;
+    std::uint32_t index;
+    layout_string value;  // literal text or format specifier
+};
+
+static constexpr inline std::uint32_t layout_magic = 0x544D4646;  // "FFMT" in little-endian byte order
+static constexpr inline std::uint32_t layout_magic_swapped = 0x46464D54;
+static constexpr inline std::uint32_t layout_version = 1;
+
+template <class T>
+struct array_view
+{
+    const T* m_data;
+    std::size_t m_size;
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    const T& operator[](std::size_t index) const
+    {
+        return m_data[index];
+    }
+
+    const T* begin() const
+    {
+        return m_data;
+    }
+
+    const T* end() const
+    {
+        return m_data + m_size;
+    }
+};
+
+struct string_table_view
+{
+    const layout_string* m_data;
+    std::size_t m_size;
+    const char* m_pool;
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    std::string_view operator[](std::size_t index) const
+    {
+        return { m_pool + m_data[index].offset, m_data[index].size };
+    }
+};
+
+inline auto pad4(std::uint64_t n) -> std::uint64_t
+{
+    return (n + 3) & ~std::uint64_t{ 3 };
+}
+
+}  // namespace detail
+
+/*
+ * Pre-parsed template stored in a template_registry. Formats like format_string, without parsing its text again.
+ */
+class compiled_template
+{
+public:
+    compiled_template(
+        const detail::layout_template* entry,
+        const detail::layout_action* actions,
+        const detail::layout_string* names,
+        const std::uint16_t* tables,
+        const char* pool)
+        : m_entry{ entry }
+        , m_actions{ actions + entry->first_action, entry->action_count }
+        , m_names{ names + entry->first_name, entry->name_count, pool }
+        , m_table{ tables + entry->first_table, entry->table_size }
+        , m_pool{ pool }
+    {
+    }
+
+    std::string_view key() const
+    {
+        return string(m_entry->key);
+    }
+
+    std::string_view text() const
+    {
+        return string(m_entry->text);
+    }
+
+    void format(format_context& format_ctx, const std::vector<detail::arg_ref>& arguments) const
+    {
+        FERRUGO_FMT_STATS_SCOPE(text(), format_ctx.output());
+        if (arguments.size() < m_entry->arg_count)
+        {
+            throw format_error{ "argument index out of range" };
+        }
+        std::vector<const detail::arg_ref*> named(m_names.size());
+        if (m_names.size() > 0)
+        {
+            detail::resolve_named_arguments(arguments, m_names, m_table, named.data());
+        }
+        format_ctx.output().ensure_free_capacity(size_hint(arguments, named.data()));
+        for (const detail::layout_action& a : m_actions)
+        {
+            const std::string_view txt = string(a.value);
+            switch (a.kind)
+            {
+                case detail::layout_action::text: format_ctx.output().append(txt.data(), txt.size()); break;
+                case detail::layout_action::argument: arguments[a.index].print(format_ctx, parse_context{ txt }); break;
+                case detail::layout_action::named_argument: named[a.index]->print(format_ctx, parse_context{ txt }); break;
+            }
+        }
+    }
+
+    auto format(const std::vector<detail::arg_ref>& arguments) const -> std::string
+    {
+        std::string result;
+        detail::format_append(result, *this, arguments);
+        return result;
+    }
+
+    std::size_t size_hint(const std::vector<detail::arg_ref>& arguments) const
+    {
+        std::vector<const detail::arg_ref*> named(m_names.size());
+        if (m_names.size() > 0)
+        {
+            detail::find_named_arguments(arguments, m_names, m_table, named.data());
+        }
+        return size_hint(arguments, named.data());
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const compiled_template& item)
+    {
+        return os << item.text();
+    }
+
+private:
+    const detail::layout_template* m_entry;
+    detail::array_view<detail::layout_action> m_actions;
+    detail::string_table_view m_names;
+    detail::array_view<std::uint16_t> m_table;
+    const char* m_pool;
+
+    std::string_view string(const detail::layout_string& s) const
+    {
+        return { m_pool + s.offset, s.size };
+    }
+
+    std::size_t size_hint(const std::vector<detail::arg_ref>& arguments, const detail::arg_ref* const* named) const
+    {
+        std::size_t result = m_entry->literal_size;
+        for (const detail::layout_action& a : m_actions)
+        {
+            switch (a.kind)
+            {
+                case detail::layout_action::text: break;
+                case detail::layout_action::argument: result += detail::field_size_hint(arguments, a.index); break;
+                case detail::layout_action::named_argument: result += detail::field_size_hint(named[a.index]); break;
+            }
+        }
+        return result;
+    }
+};
+
+namespace detail
+{
+
+template <>
+struct is_format_layout<compiled_template> : std::true_type
+{
+};
+
+}  // namespace detail
+
+/*
+ * Read-only view of templates compiled by `template_registry::compile`. It does not own the data, which must be
+ * 4-byte aligned and outlive the registry - e.g. a string, or a file mapped into memory and shared between processes.
+ * The data is validated once on construction; truncated, corrupted or foreign-endian data throws format_error.
+ */
+class template_registry
+{
+public:
+    template_registry(const void* data, std::size_t size)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(std::uint32_t) != 0)
+        {
+            throw format_error{ "template registry data is not aligned" };
+        }
+        if (size < sizeof(detail::layout_header))
+        {
+            throw format_error{ "template registry data is truncated" };
+        }
+        m_header = reinterpret_cast<const detail::layout_header*>(bytes);
+        if (m_header->magic == detail::layout_magic_swapped)
+        {
+            throw format_error{ "template registry data has a different byte order" };
+        }
+        if (m_header->magic != detail::layout_magic || m_header->version != detail::layout_version)
+        {
+            throw format_error{ "invalid template registry data" };
+        }
+        // The counts are 32-bit, so the section offsets cannot overflow 64 bits.
+        const auto section_end = [](std::uint64_t offset, std::uint32_t count, std::size_t element_size)
+        { return offset + detail::pad4(std::uint64_t{ count } * element_size); };
+        const std::uint64_t templates_offset = sizeof(detail::layout_header);
+        const std::uint64_t actions_offset
+            = section_end(templates_offset, m_header->template_count, sizeof(detail::layout_template));
+        const std::uint64_t names_offset
+            = section_end(actions_offset, m_header->action_count, sizeof(detail::layout_action));
+        const std::uint64_t tables_offset = section_end(names_offset, m_header->name_count, sizeof(detail::layout_string));
+        const std::uint64_t pool_offset = section_end(tables_offset, m_header->table_size, sizeof(std::uint16_t));
+        if (pool_offset + m_header->pool_size > size)
+        {
+            throw format_error{ "template registry data is truncated" };
+        }
+        m_templates = reinterpret_cast<const detail::layout_template*>(bytes + templates_offset);
+        m_actions = reinterpret_cast<const detail::layout_action*>(bytes + actions_offset);
+        m_names = reinterpret_cast<const detail::layout_string*>(bytes + names_offset);
+        m_tables = reinterpret_cast<const std::uint16_t*>(bytes + tables_offset);
+        m_pool = bytes + pool_offset;
+        validate();
+    }
+
+    explicit template_registry(std::string_view data) : template_registry(data.data(), data.size())
+    {
+    }
+
+    std::size_t size() const
+    {
+        return m_header->template_count;
+    }
+
+    auto find(std::string_view key) const -> std::optional<compiled_template>
+    {
+        const auto* const end = m_templates + size();
+        const auto* it = std::lower_bound(
+            m_templates,
+            end,
+            key,
+            [&](const detail::layout_template& entry, std::string_view k)
+            { return std::string_view{ m_pool + entry.key.offset, entry.key.size } < k; });
+        if (it == end || std::string_view{ m_pool + it->key.offset, it->key.size } != key)
+        {
+            return std::nullopt;
+        }
+        return compiled_template{ it, m_actions, m_names, m_tables, m_pool };
+    }
+
+    auto at(std::string_view key) const -> compiled_template
+    {
+        if (auto result = find(key))
+        {
+            return *result;
+        }
+        throw format_error{ "unknown template '" + std::string{ key } + "'" };
+    }
+
+    /*
+     * Parses the (key, text) pairs and serializes their layouts. Throws format_error on invalid templates or duplicate keys.
+     */
+    static auto compile(std::vector<std::pair<std::string, std::string>> templates) -> std::string
+    {
+        std::sort(templates.begin(), templates.end());
+        for (std::size_t i = 1; i < templates.size(); ++i)
+        {
+            if (templates[i - 1].first == templates[i].first)
+            {
+                throw format_error{ "duplicate template '" + templates[i].first + "'" };
+            }
+        }
+
+        std::vector<detail::layout_template> entries;
+        std::vector<detail::layout_action> actions;
+        std::vector<detail::layout_string> names;
+        std::vector<std::uint16_t> tables;
+        std::string pool;
+
+        const auto add_string = [&](std::string_view s) -> detail::layout_string
+        {
+            const detail::layout_string result{ static_cast<std::uint32_t>(pool.size()),
+                                                static_cast<std::uint32_t>(s.size()) };
+            pool.append(s.data(), s.size());
+            return result;
+        };
+
+        for (const auto& [key, text] : templates)
+        {
+            detail::layout_template entry{};
+            entry.key = add_string(key);
+            entry.text = add_string(text);
+            entry.first_action = static_cast<std::uint32_t>(actions.size());
+            entry.first_name = static_cast<std::uint32_t>(names.size());
+
+            struct visitor
+            {
+                detail::layout_template& entry;
+                std::vector<detail::layout_action>& actions;
+                std::vector<std::string_view> names;
+                std::string_view source;
+
+                auto ref(std::string_view s) const -> detail::layout_string
+                {
+                    if (s.empty())
+                    {
+                        return { 0, 0 };  // e.g. an absent specifier, which does not point into the text
+                    }
+                    return { static_cast<std::uint32_t>(entry.text.offset + (s.data() - source.data())),
+                             static_cast<std::uint32_t>(s.size()) };
+                }
+
+                void text(std::string_view s)
+                {
+                    actions.push_back({ detail::layout_action::text, 0, ref(s) });
+                    entry.literal_size += static_cast<std::uint32_t>(s.size());
+                }
+
+                void argument(std::size_t index, std::string_view specifier)
+                {
+                    if (index >= std::numeric_limits<std::uint32_t>::max())
+                    {
+                        throw format_error{ "argument index too large" };
+                    }
+                    actions.push_back(
+                        { detail::layout_action::argument, static_cast<std::uint32_t>(index), ref(specifier) });
+                    entry.arg_count = std::max(entry.arg_count, static_cast<std::uint32_t>(index + 1));
+                }
+
+                void named_argument(std::string_view name, std::string_view specifier)
+                {
+                    const std::size_t slot = std::find(names.begin(), names.end(), name) - names.begin();
+                    if (slot == names.size())
+                    {
+                        names.push_back(name);
+                    }
+                    actions.push_back(
+                        { detail::layout_action::named_argument, static_cast<std::uint32_t>(slot), ref(specifier) });
+                }
+            };
+
+            visitor v{ entry, actions, {}, text };
+            detail::parse_format_string(text, v);
+            if (v.names.size() >= detail::no_slot)
+            {
+                throw format_error{ "too many named arguments" };
+            }
+
+            entry.action_count = static_cast<std::uint32_t>(actions.size()) - entry.first_action;
+            entry.name_count = static_cast<std::uint32_t>(v.names.size());
+            for (std::string_view name : v.names)
+            {
+                names.push_back(v.ref(name));
+            }
+
+            std::vector<std::uint16_t> table(detail::name_table_size(v.names.size()));
+            std::vector<std::uint16_t> scratch(detail::name_scratch_size(v.names.size()));
+            detail::build_name_table(v.names, table, scratch);
+            entry.first_table = static_cast<std::uint32_t>(tables.size());
+            entry.table_size = static_cast<std::uint32_t>(table.size());
+            tables.insert(tables.end(), table.begin(), table.end());
+
+            entries.push_back(entry);
+        }
+
+        if (pool.size() > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw format_error{ "template registry too large" };
+        }
+
+        const detail::layout_header header{ detail::layout_magic,
+                                            detail::layout_version,
+                                            static_cast<std::uint32_t>(entries.size()),
+                                            static_cast<std::uint32_t>(actions.size()),
+                                            static_cast<std::uint32_t>(names.size()),
+                                            static_cast<std::uint32_t>(tables.size()),
+                                            static_cast<std::uint32_t>(pool.size()),
+                                            0 };
+
+        std::string result;
+        const auto write = [&](const void* data, std::size_t size)
+        { result.append(static_cast<const char*>(data), size); };
+        write(&header, sizeof(header));
+        write(entries.data(), entries.size() * sizeof(detail::layout_template));
+        write(actions.data(), actions.size() * sizeof(detail::layout_action));
+        write(names.data(), names.size() * sizeof(detail::layout_string));
+        write(tables.data(), tables.size() * sizeof(std::uint16_t));
+        result.resize(static_cast<std::size_t>(detail::pad4(result.size())), '\0');
+        result.append(pool);
+        return result;
+    }
+
+private:
+    const detail::layout_header* m_header;
+    const detail::layout_template* m_templates;
+    const detail::layout_action* m_actions;
+    const detail::layout_string* m_names;
+    const std::uint16_t* m_tables;
+    const char* m_pool;
+
+    // Checks once that all the indices, ranges and strings of the entries stay within their sections.
+    void validate() const
+    {
+        const auto check = [](bool condition)
+        {
+            if (!condition)
+            {
+                throw format_error{ "invalid template registry data" };
+            }
+        };
+        const auto in_range = [](std::uint32_t first, std::uint32_t count, std::uint32_t total)
+        { return std::uint64_t{ first } + count <= total; };
+        const auto check_string = [&](const detail::layout_string& s)
+        { check(in_range(s.offset, s.size, m_header->pool_size)); };
+        const auto key = [&](const detail::layout_template& e)
+        { return std::string_view{ m_pool + e.key.offset, e.key.size }; };
+
+        for (std::size_t i = 0; i < size(); ++i)
+        {
+            const detail::layout_template& entry = m_templates[i];
+            check_string(entry.key);
+            check_string(entry.text);
+            check(i == 0 || key(m_templates[i - 1]) < key(entry));
+            check(in_range(entry.first_action, entry.action_count, m_header->action_count));
+            check(in_range(entry.first_name, entry.name_count, m_header->name_count));
+            check(in_range(entry.first_table, entry.table_size, m_header->table_size));
+            check(entry.name_count < detail::no_slot);
+            check(entry.table_size == detail::name_table_size(entry.name_count));
+            for (std::uint32_t n = 0; n < entry.name_count; ++n)
+            {
+                check_string(m_names[entry.first_name + n]);
+            }
+            // The bucket seeds may have any value; the slots must refer to names.
+            for (std::size_t t = detail::name_bucket_count(entry.name_count); t < entry.table_size; ++t)
+            {
+                const std::uint16_t slot = m_tables[entry.first_table + t];
+                check(slot == detail::no_slot || slot < entry.name_count);
+            }
+            std::uint64_t literal_size = 0;
+            for (std::uint32_t a = 0; a < entry.action_count; ++a)
+            {
+                const detail::layout_action& action = m_actions[entry.first_action + a];
+                check_string(action.value);
+                switch (action.kind)
+                {
+                    case detail::layout_action::text: literal_size += action.value.size; break;
+                    case detail::layout_action::argument: check(action.index < entry.arg_count); break;
+                    case detail::layout_action::named_argument: check(action.index < entry.name_count); break;
+                    default: check(false); break;
+                }
+            }
+            check(literal_size == entry.literal_size);
+        }
+    }
+};
+
+}  // namespace fmt
+}  // namespace ferrugo
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(FERRUGO_FMT_ENABLE_STATS)
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+/*
+ * Opt-in instrumentation of format calls, enabled by defining FERRUGO_FMT_ENABLE_STATS (consistently, for the whole
+ * program). When disabled, the hooks expand to nothing and `stats()` returns no entries.
+ */
+
+namespace ferrugo
+{
+
+namespace fmt
+{
+
+// Counters of a call site, identified by its format text. The entries own a copy of the text.
+struct call_site_stats
+{
+    std::string format;
+    std::uint64_t calls;
+    std::uint64_t bytes;
+    std::uint64_t grows;
+    std::uint64_t cycles;
+
+    friend std::ostream& operator<<(std::ostream& os, const call_site_stats& item)
+    {
+        return os << "\"" << item.format << "\": calls=" << item.calls << ", bytes=" << item.bytes
+                  << ", grows=" << item.grows << ", cycles=" << item.cycles;
+    }
+};
+
+#if defined(FERRUGO_FMT_ENABLE_STATS)
+
+namespace detail
+{
+
+struct call_site_counters
+{
+    std::string format;  // owned: runtime format strings may be freed after the call
+    std::atomic<std::uint64_t> calls{ 0 };
+    std::atomic<std::uint64_t> bytes{ 0 };
+    std::atomic<std::uint64_t> grows{ 0 };
+    std::atomic<std::uint64_t> cycles{ 0 };
+
+    explicit call_site_counters(std::string_view f) : format{ f }
+    {
+    }
+
+    // Counters have a single writer (the owning thread), so no read-modify-write atomics are needed.
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+struct thread_stats
+{
+    std::mutex m_mutex;  // guards m_counters against insertions while aggregating
+    std::deque<call_site_counters> m_counters;
+    std::unordered_map<std::string_view, call_site_counters*> m_index;  // keys view the owned texts of m_counters
+    std::uint64_t m_grows = 0;
+
+    call_site_counters& get(std::string_view format)
+    {
+        const auto it = m_index.find(format);
+        if (it != m_index.end())
+        {
+            return *it->second;
+        }
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        call_site_counters& result = m_counters.emplace_back(format);
+        m_index.emplace(result.format, &result);
+        return result;
+    }
+};
+
+struct stats_registry
+{
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<thread_stats>> m_threads;
+    // Counters of the threads which have exited, merged per call site.
+    std::deque<call_site_stats> m_exited;
+    std::unordered_map<std::string_view, call_site_stats*> m_exited_index;  // keys view the texts of m_exited
+
+    static stats_registry& instance()
+    {
+        static stats_registry result;
+        return result;
+    }
+
+    thread_stats& add_thread()
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        return *m_threads.emplace_back(std::make_unique<thread_stats>());
+    }
+
+    // Merges the counters of an exiting thread into m_exited and frees them.
+    void remove_thread(thread_stats& thread)
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        for (const call_site_counters& c : thread.m_counters)
+        {
+            auto it = m_exited_index.find(c.format);
+            if (it == m_exited_index.end())
+            {
+                call_site_stats& item = m_exited.emplace_back(call_site_stats{ c.format, 0, 0, 0, 0 });
+                it = m_exited_index.emplace(item.format, &item).first;
+            }
+            it->second->calls += c.calls.load(std::memory_order_relaxed);
+            it->second->bytes += c.bytes.load(std::memory_order_relaxed);
+            it->second->grows += c.grows.load(std::memory_order_relaxed);
+            it->second->cycles += c.cycles.load(std::memory_order_relaxed);
+        }
+        m_threads.erase(std::find_if(
+            m_threads.begin(), m_threads.end(), [&](const std::unique_ptr<thread_stats>& t) { return t.get() == &thread; }));
+    }
+};
+
+// Registers the counters of a thread for its lifetime.
+class thread_stats_handle
+{
+public:
+    thread_stats_handle() : m_stats{ stats_registry::instance().add_thread() }
+    {
+    }
+
+    thread_stats_handle(const thread_stats_handle&) = delete;
+
+    ~thread_stats_handle()
+    {
+        stats_registry::instance().remove_thread(m_stats);
+    }
+
+    thread_stats& get() const
+    {
+        return m_stats;
+    }
+
+private:
+    thread_stats& m_stats;
+};
+
+// Counters of the calling thread; when the thread exits they are merged into the registry.
+inline thread_stats& this_thread_stats()
+{
+    static thread_local const thread_stats_handle handle;
+    return handle.get();
+}
+
+inline std::uint64_t read_cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Records a single format call: output bytes, buffer grow events and elapsed cycles.
+template <class Buffer>
+class call_site_scope
+{
+public:
+    call_site_scope(std::string_view format, const Buffer& buffer)
+        : m_thread{ this_thread_stats() }
+        , m_counters{ m_thread.get(format) }
+        , m_buffer{ buffer }
+        , m_written{ buffer.written() }
+        , m_grows{ m_thread.m_grows }
+        , m_start{ read_cycles() }
+    {
+    }
+
+    call_site_scope(const call_site_scope&) = delete;
+
+    ~call_site_scope()
+    {
+        const std::uint64_t end = read_cycles();
+        call_site_counters::add(m_counters.calls, 1);
+        call_site_counters::add(m_counters.bytes, m_buffer.written() - m_written);
+        call_site_counters::add(m_counters.grows, m_thread.m_grows - m_grows);
+        call_site_counters::add(m_counters.cycles, end - m_start);
+    }
+
+private:
+    thread_stats& m_thread;
+    call_site_counters& m_counters;
+    const Buffer& m_buffer;
+    std::size_t m_written;
+    std::uint64_t m_grows;
+    std::uint64_t m_start;
+};
+
+}  // namespace detail
+
+#define FERRUGO_FMT_STATS_SCOPE(format, buffer) \
+    const ::ferrugo::fmt::detail::call_site_scope<std::decay_t<decltype(buffer)>> ferrugo_fmt_stats_scope_{ format, buffer }
+#define FERRUGO_FMT_STATS_GROW() ++::ferrugo::fmt::detail::this_thread_stats().m_grows
+
+/*
+ * Aggregates the counters of all the threads per call site (format text), most expensive first.
+ */
+inline auto stats() -> std::vector<call_site_stats>
+{
+    detail::stats_registry& registry = detail::stats_registry::instance();
+    std::lock_guard<std::mutex> lock{ registry.m_mutex };
+
+    std::vector<call_site_stats> result{ registry.m_exited.begin(), registry.m_exited.end() };
+    std::unordered_map<std::string_view, std::size_t> index;  // keys view the texts of the counters, kept alive by the lock
+    for (const call_site_stats& item : registry.m_exited)
+    {
+        index.emplace(item.format, index.size());
+    }
+    for (const auto& thread : registry.m_threads)
+    {
+        std::lock_guard<std::mutex> thread_lock{ thread->m_mutex };
+        for (const detail::call_site_counters& c : thread->m_counters)
+        {
+            const auto [it, inserted] = index.emplace(c.format, result.size());
+            if (inserted)
+            {
+                result.push_back(call_site_stats{ c.format, 0, 0, 0, 0 });
+            }
+            call_site_stats& item = result[it->second];
+            item.calls += c.calls.load(std::memory_order_relaxed);
+            item.bytes += c.bytes.load(std::memory_order_relaxed);
+            item.grows += c.grows.load(std::memory_order_relaxed);
+            item.cycles += c.cycles.load(std::memory_order_relaxed);
+        }
+    }
+    std::sort(
+        result.begin(),
+        result.end(),
+        [](const call_site_stats& lhs, const call_site_stats& rhs) { return lhs.cycles > rhs.cycles; });
+    return result;
+}
+
+#else
+
+#define FERRUGO_FMT_STATS_SCOPE(format, buffer)
+#define FERRUGO_FMT_STATS_GROW()
+
+inline auto stats() -> std::vector<call_site_stats>
+{
+    return {};
+}
+
+#endif
+
+}  // namespace fmt
+}  // namespace ferrugo
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <ferrugo/fmt/format.hpp>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <string>
 #include <tuple>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 namespace ferrugo
@@ -76,6 +84,11 @@ struct formatter<std::optional<T>>
 {
     formatter<T> m_inner = {};
 
+    static constexpr void check_specifier(std::string_view spec)
+    {
+        detail::check_specifier<T>(spec);
+    }
+
     void parse(const parse_context& ctx)
     {
         m_inner.parse(ctx);
@@ -101,6 +114,11 @@ struct formatter<std::reference_wrapper<T>>
 {
     formatter<std::remove_const_t<T>> m_inner = {};
 
+    static constexpr void check_specifier(std::string_view spec)
+    {
+        detail::check_specifier<std::remove_const_t<T>>(spec);
+    }
+
     void parse(const parse_context& ctx)
     {
         m_inner.parse(ctx);
@@ -112,5 +130,510 @@ struct formatter<std::reference_wrapper<T>>
     }
 };
 
+/*
+ * Formats pointers as hex addresses, e.g. `0x7ffd5e8c`. Character pointers are formatted as strings.
+ */
+template <class T>
+struct formatter<T*, std::enable_if_t<!std::is_same_v<std::remove_cv_t<T>, char>>>
+{
+    static constexpr std::size_t size_hint(T*)
+    {
+        return 2 + 2 * sizeof(std::uintptr_t);
+    }
+
+    void parse(const parse_context&)
+    {
+    }
+
+    void format(format_context& ctx, T* item) const
+    {
+        char buffer[2 + 2 * sizeof(std::uintptr_t)];
+        char* const end = buffer + sizeof(buffer);
+        char* ptr = detail::write_power_of_two<4>(end, reinterpret_cast<std::uintptr_t>(item), detail::lower_digits);
+        *--ptr = 'x';
+        *--ptr = '0';
+        ctx.output().append(ptr, end);
+    }
+};
+
+template <>
+struct formatter<char*> : formatter<const char*>
+{
+};
+
+template <>
+struct formatter<std::nullptr_t> : formatter<const void*>
+{
+};
+
+template <class T, class D>
+struct formatter<std::unique_ptr<T, D>>
+{
+    formatter<const void*> m_inner = {};
+
+    void parse(const parse_context& ctx)
+    {
+        m_inner.parse(ctx);
+    }
+
+    void format(format_context& ctx, const std::unique_ptr<T, D>& item) const
+    {
+        m_inner.format(ctx, item.get());
+    }
+};
+
+template <class T>
+struct formatter<std::shared_ptr<T>>
+{
+    formatter<const void*> m_inner = {};
+
+    void parse(const parse_context& ctx)
+    {
+        m_inner.parse(ctx);
+    }
+
+    void format(format_context& ctx, const std::shared_ptr<T>& item) const
+    {
+        m_inner.format(ctx, item.get());
+    }
+};
+
+/*
+ * Specialize with a constexpr table to format enum values by name:
+ *
+ *     template <>
+ *     struct fmt::enum_names<color>
+ *     {
+ *         static constexpr std::pair<color, std::string_view> values[] = { { color::red, "red" }, ... };
+ *     };
+ */
+template <class E>
+struct enum_names
+{
+};
+
+namespace detail
+{
+
+template <class E, class = void>
+struct has_enum_names : std::false_type
+{
+};
+
+template <class E>
+struct has_enum_names<E, std::void_t<decltype(enum_names<E>::values)>> : std::true_type
+{
+};
+
+}  // namespace detail
+
+/*
+ * Formats enums (including std::byte) by name if `enum_names` are provided, otherwise by the underlying value.
+ * Integer format specifiers (e.g. `x`) format the underlying value.
+ */
+template <class E>
+struct formatter<E, std::enable_if_t<std::is_enum_v<E>>>
+{
+    // `char` would be formatted as a character, so char-based enums are formatted as int.
+    using underlying_type = std::underlying_type_t<E>;
+    using integer_type = std::conditional_t<std::is_same_v<underlying_type, char>, int, underlying_type>;
+
+    formatter<integer_type> m_inner = {};
+    bool m_numeric = false;
+
+    static constexpr void check_specifier(std::string_view spec)
+    {
+        detail::check_specifier<integer_type>(spec);
+    }
+
+    void parse(const parse_context& ctx)
+    {
+        m_inner.parse(ctx);
+        m_numeric = !ctx.specifier().empty();
+    }
+
+    void format(format_context& ctx, E item) const
+    {
+        if constexpr (detail::has_enum_names<E>::value)
+        {
+            if (!m_numeric)
+            {
+                for (const auto& [value, name] : enum_names<E>::values)
+                {
+                    if (value == item)
+                    {
+                        ctx.output().append(name.data(), name.size());
+                        return;
+                    }
+                }
+            }
+        }
+        m_inner.format(ctx, static_cast<integer_type>(static_cast<underlying_type>(item)));
+    }
+};
+
+template <>
+struct formatter<std::monostate>
+{
+    void parse(const parse_context&)
+    {
+    }
+
+    void format(format_context& ctx, std::monostate) const
+    {
+        write_to(ctx, "monostate");
+    }
+};
+
+/*
+ * Formats the active alternative, passing the format specifier to its formatter.
+ */
+template <class... Types>
+struct formatter<std::variant<Types...>>
+{
+    std::string_view m_spec = {};
+
+    // The specifier has to be valid for every alternative.
+    static constexpr void check_specifier(std::string_view spec)
+    {
+        (detail::check_specifier<Types>(spec), ...);
+    }
+
+    void parse(const parse_context& ctx)
+    {
+        m_spec = ctx.specifier();
+    }
+
+    void format(format_context& ctx, const std::variant<Types...>& item) const
+    {
+        if (item.valueless_by_exception())
+        {
+            write_to(ctx, "valueless");
+            return;
+        }
+        std::visit(
+            [&](const auto& value)
+            {
+                formatter<std::decay_t<decltype(value)>> inner{};
+                inner.parse(parse_context{ m_spec });
+                inner.format(ctx, value);
+            },
+            item);
+    }
+};
+
+namespace detail
+{
+
+struct civil_date
+{
+    std::int64_t year;
+    unsigned month;
+    unsigned day;
+    unsigned year_day;
+    unsigned week_day;
+};
+
+inline auto civil_from_days(std::int64_t days) -> civil_date
+{
+    // http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    const std::int64_t z = days + 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const std::int64_t y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    const unsigned year_day = m <= 2 ? doy - 305 : doy + 60 + (leap ? 1 : 0);
+    const auto week_day = static_cast<unsigned>(((days % 7) + 11) % 7);
+    return civil_date{ y, m, d, year_day, week_day };
+}
+
+inline void append_digits(std::string& out, std::uint64_t value, int width)
+{
+    char buffer[20];
+    char* const end = buffer + sizeof(buffer);
+    char* ptr = end;
+    do
+    {
+        *--ptr = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (end - ptr < width)
+    {
+        *--ptr = '0';
+    }
+    out.append(ptr, end);
+}
+
+// Number of fractional digits of %S; like std::format, 6 for floating-point counts.
+template <class Rep, class Period>
+constexpr auto subsecond_digits() -> int
+{
+    if (std::is_floating_point_v<Rep>)
+    {
+        return 6;
+    }
+    if (Period::num >= Period::den)
+    {
+        return 0;
+    }
+    std::intmax_t pow = 1;
+    for (int n = 0; n < 18; ++n, pow *= 10)
+    {
+        if (pow % Period::den == 0)
+        {
+            return n;
+        }
+    }
+    return 6;
+}
+
+constexpr auto pow10(int n) -> std::intmax_t
+{
+    return n == 0 ? 1 : 10 * pow10(n - 1);
+}
+
+template <class Period>
+constexpr auto duration_suffix() -> std::string_view
+{
+    if constexpr (std::ratio_equal_v<Period, std::nano>)
+        return "ns";
+    else if constexpr (std::ratio_equal_v<Period, std::micro>)
+        return "us";
+    else if constexpr (std::ratio_equal_v<Period, std::milli>)
+        return "ms";
+    else if constexpr (std::ratio_equal_v<Period, std::ratio<1>>)
+        return "s";
+    else if constexpr (std::ratio_equal_v<Period, std::ratio<60>>)
+        return "min";
+    else if constexpr (std::ratio_equal_v<Period, std::ratio<3600>>)
+        return "h";
+    else if constexpr (std::ratio_equal_v<Period, std::ratio<86400>>)
+        return "d";
+    else
+        return {};
+}
+
+struct time_fields
+{
+    civil_date date;
+    std::uint64_t hour;
+    std::uint64_t minute;
+    std::uint64_t second;
+    bool subseconds;
+    std::string_view count;
+};
+
+inline void validate_time_spec(std::string_view spec, std::string_view allowed_fields)
+{
+    for (std::size_t i = 0; i < spec.size(); ++i)
+    {
+        if (spec[i] == '%' && (++i == spec.size() || allowed_fields.find(spec[i]) == std::string_view::npos))
+        {
+            throw format_error{ "invalid chrono format specifier" };
+        }
+    }
+}
+
+/*
+ * Renders the strftime-like specifier into `out`. Sub-second digits are not written - instead their positions are
+ * recorded in `cuts`, so that the rendered text can be reused for all the time points within the same second.
+ */
+inline void render_time(std::string& out, std::vector<std::size_t>& cuts, std::string_view spec, const time_fields& t)
+{
+    static constexpr std::string_view week_days[]
+        = { "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday" };
+    static constexpr std::string_view months[] = { "January", "February", "March",     "April",   "May",      "June",
+                                                   "July",    "August",   "September", "October", "November", "December" };
+
+    for (std::size_t i = 0; i < spec.size(); ++i)
+    {
+        if (spec[i] != '%')
+        {
+            out.push_back(spec[i]);
+            continue;
+        }
+        switch (spec[++i])
+        {
+            case 'Y':
+                if (t.date.year < 0)
+                {
+                    out.push_back('-');
+                }
+                append_digits(out, static_cast<std::uint64_t>(t.date.year < 0 ? -t.date.year : t.date.year), 4);
+                break;
+            case 'y': append_digits(out, static_cast<std::uint64_t>((t.date.year % 100 + 100) % 100), 2); break;
+            case 'm': append_digits(out, t.date.month, 2); break;
+            case 'd': append_digits(out, t.date.day, 2); break;
+            case 'e':
+                out.push_back(t.date.day < 10 ? ' ' : static_cast<char>('0' + t.date.day / 10));
+                out.push_back(static_cast<char>('0' + t.date.day % 10));
+                break;
+            case 'j': append_digits(out, t.date.year_day, 3); break;
+            case 'a': out.append(week_days[t.date.week_day].substr(0, 3)); break;
+            case 'A': out.append(week_days[t.date.week_day]); break;
+            case 'b': out.append(months[t.date.month - 1].substr(0, 3)); break;
+            case 'B': out.append(months[t.date.month - 1]); break;
+            case 'u': append_digits(out, t.date.week_day == 0 ? 7 : t.date.week_day, 1); break;
+            case 'w': append_digits(out, t.date.week_day, 1); break;
+            case 'H': append_digits(out, t.hour, 2); break;
+            case 'I': append_digits(out, t.hour % 12 == 0 ? 12 : t.hour % 12, 2); break;
+            case 'p': out.append(t.hour % 24 < 12 ? "AM" : "PM"); break;
+            case 'M': append_digits(out, t.minute, 2); break;
+            case 'S':
+                append_digits(out, t.second, 2);
+                if (t.subseconds)
+                {
+                    out.push_back('.');
+                    cuts.push_back(out.size());
+                }
+                break;
+            case 'F': render_time(out, cuts, "%Y-%m-%d", t); break;
+            case 'T': render_time(out, cuts, "%H:%M:%S", t); break;
+            case 'R': render_time(out, cuts, "%H:%M", t); break;
+            case 'D': render_time(out, cuts, "%m/%d/%y", t); break;
+            case 'z': out.append("+0000"); break;
+            case 'Z': out.append("UTC"); break;
+            case 'Q': out.append(t.count); break;
+            case 'n': out.push_back('\n'); break;
+            case 't': out.push_back('\t'); break;
+            case '%': out.push_back('%'); break;
+            default: break;
+        }
+    }
+}
+
+inline void write_time(
+    format_context& ctx, std::string_view text, const std::vector<std::size_t>& cuts, std::uint64_t fraction, int digits)
+{
+    char frac[18];
+    for (int n = digits; n > 0; --n, fraction /= 10)
+    {
+        frac[n - 1] = static_cast<char>('0' + fraction % 10);
+    }
+    std::size_t pos = 0;
+    for (std::size_t cut : cuts)
+    {
+        ctx.output().append(text.data() + pos, cut - pos);
+        ctx.output().append(frac, digits);
+        pos = cut;
+    }
+    ctx.output().append(text.data() + pos, text.size() - pos);
+}
+
+}  // namespace detail
+
+/*
+ * Formats durations. With an empty specifier the count is followed by the unit suffix, e.g. `42ms`.
+ * Otherwise strftime-like %H, %M, %S, %T, %R and %Q (the raw count) fields are supported; %H is the total number of hours.
+ */
+template <class Rep, class Period>
+struct formatter<std::chrono::duration<Rep, Period>>
+{
+    std::string_view m_spec = {};
+
+    void parse(const parse_context& ctx)
+    {
+        m_spec = ctx.specifier();
+        detail::validate_time_spec(m_spec, "HIpMSTRQnt%");
+    }
+
+    void format(format_context& ctx, const std::chrono::duration<Rep, Period>& item) const
+    {
+        if (m_spec.empty())
+        {
+            write_to(ctx, item.count());
+            if constexpr (!detail::duration_suffix<Period>().empty())
+            {
+                write_to(ctx, detail::duration_suffix<Period>());
+            }
+            else
+            {
+                write_to(ctx, "[", Period::num, "/", Period::den, "]s");
+            }
+            return;
+        }
+
+        constexpr int digits = detail::subsecond_digits<Rep, Period>();
+        using precision = std::chrono::duration<std::intmax_t, std::ratio<1, detail::pow10(digits)>>;
+
+        const bool negative = item < std::chrono::duration<Rep, Period>::zero();
+        const auto total = std::chrono::duration_cast<precision>(negative ? -item : item);
+        const auto secs = std::chrono::duration_cast<std::chrono::seconds>(total);
+        const auto count = std::to_string(item.count());
+        const auto s = static_cast<std::uint64_t>(secs.count());
+
+        std::string text = negative ? "-" : "";
+        std::vector<std::size_t> cuts;
+        detail::render_time(text, cuts, m_spec, detail::time_fields{ {}, s / 3600, s / 60 % 60, s % 60, digits > 0, count });
+        detail::write_time(ctx, text, cuts, static_cast<std::uint64_t>((total - secs).count()), digits);
+    }
+};
+
+/*
+ * Formats system clock time points (in UTC) using strftime-like specifiers; the default one is `%Y-%m-%d %H:%M:%S`.
+ * %S is followed by the fractional part if the duration is finer than a second.
+ * The text rendered for the last seen second is cached per thread, so that consecutive timestamps only need to write
+ * their sub-second digits; the calendar date is cached until the day changes.
+ */
+template <class Duration>
+struct formatter<std::chrono::time_point<std::chrono::system_clock, Duration>>
+{
+    std::string_view m_spec = "%Y-%m-%d %H:%M:%S";
+
+    void parse(const parse_context& ctx)
+    {
+        if (!ctx.specifier().empty())
+        {
+            m_spec = ctx.specifier();
+        }
+        detail::validate_time_spec(m_spec, "YymdejaAbBuwHIpMSFTRDzZnt%");
+    }
+
+    void format(format_context& ctx, const std::chrono::time_point<std::chrono::system_clock, Duration>& item) const
+    {
+        constexpr int digits = detail::subsecond_digits<typename Duration::rep, typename Duration::period>();
+        using precision = std::chrono::duration<std::intmax_t, std::ratio<1, detail::pow10(digits)>>;
+
+        struct cache_t
+        {
+            std::string spec;
+            std::int64_t second = std::numeric_limits<std::int64_t>::min();
+            std::int64_t day = std::numeric_limits<std::int64_t>::min();
+            detail::civil_date date = {};
+            std::string text;
+            std::vector<std::size_t> cuts;
+        };
+
+        static thread_local cache_t cache;
+
+        const auto tp = std::chrono::time_point_cast<precision>(item);
+        const auto secs = std::chrono::floor<std::chrono::seconds>(tp);
+        const std::int64_t second = secs.time_since_epoch().count();
+
+        if (second != cache.second || m_spec != cache.spec)
+        {
+            const std::int64_t day = second >= 0 ? second / 86400 : (second - 86399) / 86400;
+            if (day != cache.day)
+            {
+                cache.date = detail::civil_from_days(day);
+                cache.day = day;
+            }
+            const auto s = static_cast<std::uint64_t>(second - day * 86400);
+            cache.spec.assign(m_spec.data(), m_spec.size());
+            cache.second = second;
+            cache.text.clear();
+            cache.cuts.clear();
+            detail::render_time(
+                cache.text, cache.cuts, m_spec, detail::time_fields{ cache.date, s / 3600, s / 60 % 60, s % 60, digits > 0, {} });
+        }
+        detail::write_time(ctx, cache.text, cache.cuts, static_cast<std::uint64_t>((tp - secs).count()), digits);
+    }
+};
+
 }  // namespace fmt
 }  // namespace ferrugo
\ No newline at end of file
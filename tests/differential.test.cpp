@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ferrugo/fmt/fmt.hpp>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ferrugo;
+
+/*
+ * Differential tests of the numeric formatters against std::to_chars. The exhaustive runs are tagged as hidden;
+ * run them explicitly with `ferrugo-fmt-tests [differential]`.
+ */
+
+namespace
+{
+
+// Calls `check(i)` for every i in [0, count) on all the hardware threads; returns the first reported mismatch.
+template <class Check>
+auto run_parallel(std::uint64_t count, Check check) -> std::string
+{
+    const std::uint64_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<bool> failed{ false };
+    std::mutex mutex;
+    std::string result;
+
+    std::vector<std::thread> threads;
+    for (std::uint64_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                const std::uint64_t first = count / thread_count * t;
+                const std::uint64_t last = t + 1 == thread_count ? count : count / thread_count * (t + 1);
+                for (std::uint64_t i = first; i < last && !failed.load(std::memory_order_relaxed); ++i)
+                {
+                    std::string mismatch = check(i);
+                    if (!mismatch.empty())
+                    {
+                        std::lock_guard<std::mutex> lock{ mutex };
+                        if (!failed.exchange(true))
+                        {
+                            result = std::move(mismatch);
+                        }
+                    }
+                }
+            });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    return result;
+}
+
+template <class T>
+auto reference(T value, char type) -> std::string
+{
+    char buffer[128];
+    std::to_chars_result res{};
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        res = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6);
+        if (res.ec != std::errc{})
+        {
+            std::string large(512, '\0');
+            res = std::to_chars(large.data(), large.data() + large.size(), value, std::chars_format::fixed, 6);
+            return std::string(large.data(), res.ptr);
+        }
+    }
+    else
+    {
+        const int base = type == 'x' || type == 'X' ? 16 : type == 'b' ? 2 : type == 'o' ? 8 : 10;
+        res = std::to_chars(buffer, buffer + sizeof(buffer), value, base);
+        if (type == 'X')
+        {
+            std::transform(buffer, res.ptr, buffer, [](char c) { return static_cast<char>(std::toupper(c)); });
+        }
+    }
+    return std::string(buffer, res.ptr);
+}
+
+// Formats `value` with all the integer presentations and compares the results with std::to_chars.
+template <class T>
+auto check_integer(T value) -> std::string
+{
+    static const auto formats = std::array{ fmt::format("{}"), fmt::format("{:x}"), fmt::format("{:X}"),
+                                            fmt::format("{:b}"), fmt::format("{:o}") };
+    static constexpr char types[] = { 'd', 'x', 'X', 'b', 'o' };
+    for (std::size_t i = 0; i < formats.size(); ++i)
+    {
+        const std::string actual = formats[i](value);
+        const std::string expected = reference(value, types[i]);
+        if (actual != expected)
+        {
+            return "'" + std::string{ types[i] } + "' " + expected + ": got " + actual;
+        }
+    }
+    return {};
+}
+
+template <class T>
+auto check_float(T value) -> std::string
+{
+    const std::string actual = fmt::format("{}")(value);
+    const std::string expected = reference(value, 'f');
+    return actual != expected ? expected + ": got " + actual : std::string{};
+}
+
+template <class T, class U>
+auto bit_cast(U value) -> T
+{
+    static_assert(sizeof(T) == sizeof(U));
+    T result;
+    std::memcpy(&result, &value, sizeof(T));
+    return result;
+}
+
+// Random 64-bit patterns; the seed depends only on the index so that the results do not depend on the thread count.
+auto random_bits(std::uint64_t index) -> std::uint64_t
+{
+    std::mt19937_64 engine{ index };
+    return engine();
+}
+
+// Random 64-bit values whose magnitudes are spread uniformly over the number of digits.
+auto random_integer(std::uint64_t index) -> std::uint64_t
+{
+    const std::uint64_t bits = random_bits(index);
+    return bits >> (bits % 64);
+}
+
+}  // namespace
+
+TEST_CASE("differential - integers", "[differential]")
+{
+    const auto check = [](std::uint64_t i) -> std::string
+    {
+        const std::uint64_t value = random_integer(i);
+        std::string result = check_integer(value);
+        if (result.empty())
+        {
+            result = check_integer(static_cast<std::int64_t>(value));
+        }
+        if (result.empty())
+        {
+            result = check_integer(static_cast<std::int32_t>(value));
+        }
+        return result;
+    };
+    REQUIRE(run_parallel(100'000, check) == "");
+    REQUIRE(check_integer(std::numeric_limits<std::int64_t>::min()) == "");
+    REQUIRE(check_integer(std::numeric_limits<std::uint64_t>::max()) == "");
+    REQUIRE(check_integer(std::numeric_limits<std::int8_t>::min()) == "");
+}
+
+TEST_CASE("differential - floats", "[differential]")
+{
+    const auto check = [](std::uint64_t i) -> std::string
+    {
+        const std::uint64_t bits = random_bits(i);
+        std::string result = check_float(bit_cast<double>(bits));
+        if (result.empty())
+        {
+            result = check_float(bit_cast<float>(static_cast<std::uint32_t>(bits)));
+        }
+        return result;
+    };
+    REQUIRE(run_parallel(20'000, check) == "");
+    REQUIRE(check_float(std::numeric_limits<double>::max()) == "");
+    REQUIRE(check_float(std::numeric_limits<double>::denorm_min()) == "");
+    REQUIRE(check_float(-0.0) == "");
+}
+
+TEST_CASE("differential - exhaustive 32-bit integers", "[.differential]")
+{
+    const auto check = [](std::uint64_t i) -> std::string
+    {
+        std::string result = check_integer(static_cast<std::uint32_t>(i));
+        if (result.empty())
+        {
+            result = check_integer(static_cast<std::int32_t>(i));
+        }
+        return result;
+    };
+    REQUIRE(run_parallel(std::uint64_t{ 1 } << 32, check) == "");
+}
+
+TEST_CASE("differential - exhaustive 32-bit floats", "[.differential]")
+{
+    const auto check = [](std::uint64_t i) { return check_float(bit_cast<float>(static_cast<std::uint32_t>(i))); };
+    REQUIRE(run_parallel(std::uint64_t{ 1 } << 32, check) == "");
+}
+
+TEST_CASE("differential - randomized 64-bit", "[.differential]")
+{
+    const auto check = [](std::uint64_t i) -> std::string
+    {
+        const std::uint64_t bits = random_bits(i);
+        std::string result = check_integer(random_integer(i));
+        if (result.empty())
+        {
+            result = check_integer(static_cast<std::int64_t>(bits));
+        }
+        if (result.empty())
+        {
+            result = check_float(bit_cast<double>(bits));
+        }
+        return result;
+    };
+    REQUIRE(run_parallel(100'000'000, check) == "");
+}
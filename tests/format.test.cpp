@@ -95,3 +95,429 @@ TEST_CASE("join", "")
         fmt::format("{} has {}.")("Alice", fmt::join(std::vector{ "a cat", "a dog", "a turtle" }, ", ")),
         matchers::equal_to("Alice has a cat, a dog, a turtle."sv));
 }
+
+TEST_CASE("format - durations", "")
+{
+    using namespace std::chrono_literals;
+    REQUIRE_THAT(  //
+        fmt::format("{} {} {} {}")(42ms, 3s, 15min, std::chrono::duration<int, std::ratio<1, 3>>{ 2 }),
+        matchers::equal_to("42ms 3s 15min 2[1/3]s"sv));
+    REQUIRE_THAT(  //
+        fmt::format("{:%T} {:%H:%M} {:%Q}")(3723s + 45ms, 26h + 5min, 12us),
+        matchers::equal_to("01:02:03.045 26:05 12"sv));
+    REQUIRE_THAT(fmt::format("{:%M:%S}")(-90s), matchers::equal_to("-01:30"sv));
+    const auto seconds = std::chrono::duration<double>{ 1.5 };
+    const auto millis = std::chrono::duration<float, std::milli>{ 2500 };
+    REQUIRE_THAT(fmt::format("{:%T} {:%M:%S}")(seconds, millis), matchers::equal_to("00:00:01.500000 00:02.500000"sv));
+}
+
+TEST_CASE("format - time points", "")
+{
+    using namespace std::chrono_literals;
+    using sys_seconds = std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
+    const auto tp = sys_seconds{ 1700000000s };
+    REQUIRE_THAT(fmt::format("{}")(tp), matchers::equal_to("2023-11-14 22:13:20"sv));
+    REQUIRE_THAT(  //
+        fmt::format("{:%a %d %b %Y %I:%M %p, day %j} {:%F %T}")(tp, tp + 5ms),
+        matchers::equal_to("Tue 14 Nov 2023 10:13 PM, day 318 2023-11-14 22:13:20.005"sv));
+    REQUIRE_THAT(  //
+        fmt::format("{:%T} {:%T} {:%T}")(tp + 1ms, tp + 999ms, tp + 1000ms),
+        matchers::equal_to("22:13:20.001 22:13:20.999 22:13:21.000"sv));
+    REQUIRE_THAT(  //
+        fmt::format("{:%F %T}")(sys_seconds{} - 1s),
+        matchers::equal_to("1969-12-31 23:59:59"sv));
+    REQUIRE_THROWS_AS(fmt::format("{:%Q}")(tp), fmt::format_error);
+}
+
+TEST_CASE("format - integer presentations", "")
+{
+    REQUIRE_THAT(  //
+        fmt::format("{:x} {:X} {:b} {:o} {:d}")(255, 255u, 5, 8, -42),
+        matchers::equal_to("ff FF 101 10 -42"sv));
+    REQUIRE_THAT(  //
+        fmt::format("{:#x} {:#X} {:#b} {:#o} {:#o}")(255, 255, 5, 8, 0),
+        matchers::equal_to("0xff 0XFF 0b101 010 0"sv));
+    REQUIRE_THAT(  //
+        fmt::format("{} {} {:x}")(
+            std::numeric_limits<long long>::min(), std::numeric_limits<unsigned long long>::max(), static_cast<short>(-1)),
+        matchers::equal_to("-9223372036854775808 18446744073709551615 -1"sv));
+    REQUIRE_THROWS_AS(fmt::format("{:q}")(1), fmt::format_error);
+}
+
+TEST_CASE("format - hex", "")
+{
+    const std::vector<unsigned char> bytes = { 0x00, 0x01, 0x7F, 0x80, 0xAB, 0xCD, 0xEF, 0xFF, 0x10, 0x20,
+                                               0x30, 0x40, 0x50, 0x60, 0x70, 0x90, 0xA0, 0xB0, 0xC0 };
+    REQUIRE_THAT(  //
+        fmt::format("{} {:X}")(fmt::hex(bytes), fmt::hex("\x12\x34"sv)),
+        matchers::equal_to("00017f80abcdefff1020304050607090a0b0c0 1234"sv));
+    REQUIRE_THAT(fmt::format("{}")(fmt::hex("ab")), matchers::equal_to("6162"sv));
+    REQUIRE_THAT(fmt::format("[{}]")(fmt::hex(bytes.data(), 0)), matchers::equal_to("[]"sv));
+}
+
+TEST_CASE("format - invalid format strings", "")
+{
+    REQUIRE_THROWS_AS(fmt::format("{"), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format("abc {0"), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format("abc }"), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format("{1a}"), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format("{} {}")(1), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format("{2}")(1, 2), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format("{18446744073709551615}")(1), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format("{4294967296}")(1), fmt::format_error);
+    REQUIRE_THAT(fmt::format("{{}} }} {{")(), matchers::equal_to("{} } {"sv));
+}
+
+TEST_CASE("format - compile time format string", "")
+{
+    REQUIRE_THAT(  //
+        fmt::format(FERRUGO_FMT_STRING("{1} has {0:x} {{cats}}."))(255, "Alice"),
+        matchers::equal_to("Alice has ff {cats}."sv));
+    REQUIRE_THAT(  //
+        core::str(fmt::format(FERRUGO_FMT_STRING("{1} has {:abc}."))),
+        matchers::equal_to("{1} has {1:abc}."sv));
+
+    std::stringstream ss;
+    fmt::println(ss, FERRUGO_FMT_STRING("{}-{}"))("ABC", 42);
+    REQUIRE_THAT(ss.str(), matchers::equal_to("ABC-42\n"sv));
+}
+
+TEST_CASE("format - compile time check of wrapped arguments", "")
+{
+    const auto invalid = FERRUGO_FMT_STRING("{:q}");
+    const auto valid = FERRUGO_FMT_STRING("{:x}");
+    using invalid_format = fmt::detail::static_format_string<std::decay_t<decltype(invalid)>>;
+    using valid_format = fmt::detail::static_format_string<std::decay_t<decltype(valid)>>;
+
+    REQUIRE_THROWS_AS(invalid_format::check<fmt::detail::named_arg<int>>(), fmt::format_error);
+    REQUIRE_THROWS_AS(invalid_format::check<std::reference_wrapper<const int>>(), fmt::format_error);
+    REQUIRE_THROWS_AS(invalid_format::check<std::optional<int>>(), fmt::format_error);
+    REQUIRE_THROWS_AS((invalid_format::check<std::variant<int, std::string>>()), fmt::format_error);
+    static_assert(valid_format::check<fmt::detail::named_arg<int>>());
+    static_assert(valid_format::check<std::reference_wrapper<const int>>());
+    static_assert(valid_format::check<std::optional<int>>());
+    static_assert(valid_format::check<std::variant<int, std::string>>());
+}
+
+TEST_CASE("format - size hint", "")
+{
+    const std::string text(2000, 'x');
+    const std::string_view view = "abc";
+    const int number = 42;
+    const char character = 'c';
+    const auto arguments = fmt::detail::wrap_args(text, view, number, character);
+    REQUIRE(fmt::detail::format_string("<{}> {} {} {}").size_hint(arguments) == 5 + 2000 + 3 + 11 + 1);
+    REQUIRE(fmt::detail::format_string("{0}{0}{0}").size_hint(arguments) == 3 * 2000);
+    REQUIRE(fmt::detail::format_string("{2}").size_hint(arguments) == 11);
+    REQUIRE(fmt::detail::format_string("{2} {5}").size_hint(arguments) == 1 + 11);
+
+    const auto text_arg = fmt::arg("text", text);
+    const auto named = fmt::detail::wrap_args(text_arg, number);
+    REQUIRE(fmt::detail::format_string("{text}{text}").size_hint(named) == 2 * 2000);
+    REQUIRE(fmt::detail::format_string("{text}{missing}").size_hint(named) == 2000);
+
+    const auto result = fmt::format("<{}> {}")(text, 42);
+    REQUIRE(result.size() == 1 + 2000 + 2 + 2);
+}
+
+TEST_CASE("format_append", "")
+{
+    std::string text = "Alice";
+    text.reserve(100);
+    const char* const data = text.data();
+    fmt::format_append(text, " has {}.")("a cat");
+    fmt::format_append(text, FERRUGO_FMT_STRING(" {}={:x}"))("id", 255);
+    REQUIRE_THAT(text, matchers::equal_to("Alice has a cat. id=ff"sv));
+    REQUIRE(text.data() == data);
+
+    REQUIRE_THROWS_AS(fmt::format_append(text, "{:q}")(1), fmt::format_error);
+    REQUIRE_THAT(text, matchers::equal_to("Alice has a cat. id=ff"sv));
+}
+
+TEST_CASE("format - named arguments", "")
+{
+    const std::string user = "Alice";
+    REQUIRE_THAT(  //
+        fmt::format("{user} took {ms}ms, {user:}! {}")(3.5F, fmt::arg("ms", 42), fmt::arg("user", user)),
+        matchers::equal_to("Alice took 42ms, Alice! 3.500000"sv));
+    REQUIRE_THAT(  //
+        fmt::format(FERRUGO_FMT_STRING("{user} took {ms:x}ms"))(fmt::arg("user", user), fmt::arg("ms", 255)),
+        matchers::equal_to("Alice took ffms"sv));
+    REQUIRE_THAT(core::str(fmt::detail::format_string("{user} took {ms:x}ms")), matchers::equal_to("{user} took {ms:x}ms"sv));
+    REQUIRE_THROWS_AS(fmt::format("{user} took {ms}ms")(fmt::arg("user", user)), fmt::format_error);
+
+    // Names whose unmixed hashes collide in the low bits for every seed.
+    REQUIRE_THAT(fmt::format("{n42296}{n1}")(fmt::arg("n1", 1), fmt::arg("n42296", 2)), matchers::equal_to("21"sv));
+    REQUIRE_THAT(  //
+        fmt::format(FERRUGO_FMT_STRING("{n42296}{n1}"))(fmt::arg("n1", 1), fmt::arg("n42296", 2)),
+        matchers::equal_to("21"sv));
+}
+
+TEST_CASE("format - many named arguments", "")
+{
+    // The name table grows linearly with the number of names.
+    REQUIRE(fmt::detail::name_table_size(1000) <= 4 * 1000);
+
+    std::string format_string;
+    std::string expected;
+    fmt::dynamic_format_arg_store store;
+    for (int i = 0; i < 1000; ++i)
+    {
+        format_string += "{name" + std::to_string(999 - i) + "}";
+        expected += std::to_string(999 - i);
+        store.push_back(fmt::arg("name" + std::to_string(i), i));
+    }
+    REQUIRE_THAT(fmt::format(format_string)(store), matchers::equal_to(expected));
+    const std::string data = fmt::template_registry::compile({ { "many", format_string } });
+    REQUIRE_THAT(fmt::format(fmt::template_registry{ data }.at("many"))(store), matchers::equal_to(expected));
+}
+
+TEST_CASE("template registry", "")
+{
+    const std::string data = fmt::template_registry::compile({
+        { "greeting", "Hello, {}!" },
+        { "timing", "{user} took {ms:x}ms ({0})" },
+        { "empty", "" },
+    });
+    const fmt::template_registry registry{ data };
+    REQUIRE(registry.size() == 3);
+    REQUIRE(!registry.find("unknown"));
+    REQUIRE_THROWS_AS(registry.at("unknown"), fmt::format_error);
+
+    REQUIRE_THAT(fmt::format(registry.at("greeting"))("Alice"), matchers::equal_to("Hello, Alice!"sv));
+    REQUIRE_THAT(  //
+        fmt::format(registry.at("timing"))(fmt::arg("ms", 255), fmt::arg("user", "Bob")),
+        matchers::equal_to("Bob took ffms (255)"sv));
+    REQUIRE_THAT(fmt::format(registry.at("empty"))(), matchers::equal_to(""sv));
+    REQUIRE_THAT(core::str(fmt::format(registry.at("timing"))), matchers::equal_to("{user} took {ms:x}ms ({0})"sv));
+
+    std::stringstream ss;
+    fmt::println(ss, registry.at("greeting"))("Carol");
+    REQUIRE_THAT(ss.str(), matchers::equal_to("Hello, Carol!\n"sv));
+
+    REQUIRE_THROWS_AS(fmt::template_registry::compile({ { "a", "{" } }), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::template_registry::compile({ { "a", "" }, { "a", "" } }), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::template_registry(data.data(), 16), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::template_registry::compile({ { "a", "{4294967295}" } }), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::template_registry::compile({ { "a", "{4294967296}" } }), fmt::format_error);
+}
+
+TEST_CASE("template registry - corrupted data", "")
+{
+    const std::string data = fmt::template_registry::compile({
+        { "greeting", "Hello, {}!" },
+        { "timing", "{user} took {ms:x}ms ({0})" },
+    });
+    for (std::size_t size = 0; size < data.size(); ++size)
+    {
+        REQUIRE_THROWS_AS(fmt::template_registry(data.data(), size), fmt::format_error);
+    }
+
+    std::string swapped = data;
+    std::reverse(swapped.begin(), swapped.begin() + 4);
+    REQUIRE_THROWS_AS(fmt::template_registry{ swapped }, fmt::format_error);
+
+    // Corrupting any word must be either detected or harmless.
+    for (std::size_t offset = 0; offset + 4 <= data.size(); offset += 4)
+    {
+        for (const std::uint32_t value : { 0xFFFFFFFFu, 0x7FFFFFFFu, 0x100u, 0x3u })
+        {
+            std::string corrupted = data;
+            std::memcpy(corrupted.data() + offset, &value, sizeof(value));
+            try
+            {
+                const fmt::template_registry registry{ corrupted };
+                for (std::string_view key : { "greeting"sv, "timing"sv })
+                {
+                    if (const auto entry = registry.find(key))
+                    {
+                        fmt::format(*entry)(fmt::arg("ms", 255), fmt::arg("user", "Bob"));
+                    }
+                }
+            }
+            catch (const fmt::format_error&)
+            {
+            }
+        }
+    }
+}
+
+TEST_CASE("format_chunked", "")
+{
+    const std::vector<int> values(1000, 12345);
+    const std::string expected = fmt::format("values: {}")(values);
+
+    std::vector<std::string> chunks;
+    fmt::format_chunked([&](std::string_view chunk) { chunks.emplace_back(chunk); }, "values: {}", 64)(values);
+    REQUIRE(chunks.size() > 1);
+    std::string actual;
+    for (const std::string& chunk : chunks)
+    {
+        REQUIRE(chunk.size() <= 64);
+        actual += chunk;
+    }
+    REQUIRE_THAT(actual, matchers::equal_to(expected));
+
+    chunks.clear();
+    const std::string long_text(100, 'x');
+    fmt::format_chunked([&](std::string_view chunk) { chunks.emplace_back(chunk); }, FERRUGO_FMT_STRING("<{}>"), 16)(long_text);
+    REQUIRE(chunks.size() == 3);
+    REQUIRE_THAT(chunks[0], matchers::equal_to("<"sv));
+    REQUIRE_THAT(chunks[1], matchers::equal_to(long_text));
+    REQUIRE_THAT(chunks[2], matchers::equal_to(">"sv));
+
+    chunks.clear();
+    const std::vector<std::uint8_t> block(100'000, 0xAB);
+    fmt::format_chunked([&](std::string_view chunk) { chunks.emplace_back(chunk); }, "{:X}", 4096)(fmt::hex(block));
+    actual.clear();
+    for (const std::string& chunk : chunks)
+    {
+        REQUIRE(chunk.size() <= 4096);
+        actual += chunk;
+    }
+    REQUIRE(actual.size() == 200'000);
+    REQUIRE(actual.find_first_not_of("AB") == std::string::npos);
+}
+
+TEST_CASE("print - large output", "")
+{
+    const std::vector<int> values(100000, 12345);
+    std::stringstream ss;
+    fmt::println(ss, "{}")(values);
+    REQUIRE_THAT(ss.str(), matchers::equal_to(fmt::format("{}\n")(values)));
+}
+
+namespace
+{
+
+struct alignas(64) over_aligned
+{
+    int value;
+};
+
+}  // namespace
+
+template <>
+struct ferrugo::fmt::formatter<over_aligned>
+{
+    void parse(const parse_context&)
+    {
+    }
+
+    void format(format_context& ctx, const over_aligned& item) const
+    {
+        const bool aligned = reinterpret_cast<std::uintptr_t>(&item) % alignof(over_aligned) == 0;
+        write_to(ctx, item.value, aligned ? "" : " (misaligned)");
+    }
+};
+
+TEST_CASE("dynamic_format_arg_store - over-aligned values", "")
+{
+    fmt::dynamic_format_arg_store store{ 256 };
+    for (int i = 0; i < 10; ++i)
+    {
+        store.push_back(i);
+        store.push_back(over_aligned{ i });
+    }
+    REQUIRE_THAT(  //
+        fmt::format("{1} {3} {5} {7} {9} {11} {13} {15} {17} {19}")(store),
+        matchers::equal_to("0 1 2 3 4 5 6 7 8 9"sv));
+}
+
+TEST_CASE("dynamic_format_arg_store", "")
+{
+    const int referenced = 7;
+    fmt::dynamic_format_arg_store store{ 64 };
+    {
+        std::string name = "Alice";
+        store.push_back(42);
+        store.push_back(name);
+        store.push_back("literal");
+        store.push_back(std::vector<std::string>{ "a", "b" });
+        store.push_back(std::string(200, 'x'));
+        store.push_back(fmt::arg(std::string{ "user" }, std::string{ "Bob" }));
+        store.push_back(std::cref(referenced));
+        name = "changed";
+    }
+    REQUIRE(store.size() == 7);
+    REQUIRE_THAT(  //
+        fmt::format("{} {} {} {} {user} {6}")(store),
+        matchers::equal_to("42 Alice literal [a, b] Bob 7"sv));
+    REQUIRE_THAT(fmt::format(FERRUGO_FMT_STRING("{4}"))(store), matchers::equal_to(std::string(200, 'x')));
+
+    store.clear();
+    store.push_back(1.5);
+    REQUIRE_THAT(fmt::format("{}")(store), matchers::equal_to("1.500000"sv));
+    REQUIRE_THROWS_AS(fmt::format(FERRUGO_FMT_STRING("{3}"))(store), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format(FERRUGO_FMT_STRING("{} {}"))(store), fmt::format_error);
+    REQUIRE_THROWS_AS(fmt::format(FERRUGO_FMT_STRING("{user}"))(store), fmt::format_error);
+}
+
+namespace
+{
+
+enum class color
+{
+    red,
+    green,
+    blue = 10
+};
+
+enum class unnamed : short
+{
+    a = -3
+};
+
+enum class op : char
+{
+    add = '+'
+};
+
+}  // namespace
+
+template <>
+struct ferrugo::fmt::enum_names<color>
+{
+    static constexpr std::pair<color, std::string_view> values[] = { { color::red, "red" }, { color::green, "green" } };
+};
+
+TEST_CASE("format - pointers", "")
+{
+    int value = 0;
+    const auto address = reinterpret_cast<std::uintptr_t>(&value);
+    std::stringstream ss;
+    ss << "0x" << std::hex << address;
+
+    REQUIRE_THAT(fmt::format("{}")(&value), matchers::equal_to(ss.str()));
+    REQUIRE_THAT(fmt::format("{}")(static_cast<const void*>(&value)), matchers::equal_to(ss.str()));
+    REQUIRE_THAT(fmt::format("{} {}")(nullptr, static_cast<int*>(nullptr)), matchers::equal_to("0x0 0x0"sv));
+
+    const auto unique = std::make_unique<int>(1);
+    const auto shared = std::make_shared<int>(2);
+    REQUIRE_THAT(fmt::format("{}")(unique), matchers::equal_to(fmt::format("{}")(unique.get())));
+    REQUIRE_THAT(fmt::format("{}")(shared), matchers::equal_to(fmt::format("{}")(shared.get())));
+
+    char text[] = "abc";
+    REQUIRE_THAT(fmt::format("{}")(static_cast<char*>(text)), matchers::equal_to("abc"sv));
+}
+
+TEST_CASE("format - enums", "")
+{
+    REQUIRE_THAT(  //
+        fmt::format("{} {} {} {:d} {}")(color::red, color::green, color::blue, color::green, unnamed::a),
+        matchers::equal_to("red green 10 1 -3"sv));
+    REQUIRE_THAT(  //
+        fmt::format(FERRUGO_FMT_STRING("{} {:#x}"))(std::byte{ 255 }, std::byte{ 16 }),
+        matchers::equal_to("255 0x10"sv));
+    REQUIRE_THAT(fmt::format(FERRUGO_FMT_STRING("{} {:x}"))(op::add, op::add), matchers::equal_to("43 2b"sv));
+    REQUIRE_THAT(fmt::format("{} {:x}")(op::add, op::add), matchers::equal_to("43 2b"sv));
+}
+
+TEST_CASE("format - variant", "")
+{
+    using variant_type = std::variant<std::monostate, int, std::string, color>;
+    REQUIRE_THAT(  //
+        fmt::format("{} {} {:x} {} {}")(
+            variant_type{}, variant_type{ 42 }, variant_type{ 255 }, variant_type{ "Alice" }, variant_type{ color::red }),
+        matchers::equal_to("monostate 42 ff Alice red"sv));
+}
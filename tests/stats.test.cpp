@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+#include <ferrugo/fmt/fmt.hpp>
+#include <thread>
+
+#include "matchers.hpp"
+
+using namespace std::string_view_literals;
+
+using namespace ferrugo;
+
+namespace
+{
+
+auto find_stats(std::string_view format) -> fmt::call_site_stats
+{
+    for (const auto& item : fmt::stats())
+    {
+        if (item.format == format)
+        {
+            return item;
+        }
+    }
+    return fmt::call_site_stats{ std::string{ format }, 0, 0, 0, 0 };
+}
+
+}  // namespace
+
+TEST_CASE("stats - counts calls and bytes per call site", "[stats]")
+{
+    static constexpr std::string_view fmt_text = "{} has {}.";
+    static const std::string animals(100, 'x');  // longer than any small string buffer
+    const auto before = find_stats(fmt_text);
+
+    REQUIRE_THAT(fmt::format(fmt_text)("Alice", animals), matchers::equal_to("Alice has " + animals + "."));
+    std::thread{ [] { fmt::format(fmt_text)("Bob", animals); } }.join();
+
+    const auto after = find_stats(fmt_text);
+    REQUIRE(after.calls - before.calls == 2);
+    REQUIRE(after.bytes - before.bytes == 220);
+    // Each call reserves its output once, from the size hint.
+    REQUIRE(after.grows - before.grows == 2);
+}
+
+TEST_CASE("stats - counts buffer grow events", "[stats]")
+{
+    static constexpr std::string_view fmt_text = "{}";
+    const auto before = find_stats(fmt_text);
+
+    std::stringstream ss;
+    fmt::print(ss, fmt_text)(fmt::join(std::vector<int>(1000, 42), ","));
+
+    const auto after = find_stats(fmt_text);
+    REQUIRE(after.calls - before.calls == 1);
+    REQUIRE(after.bytes - before.bytes == ss.str().size());
+    REQUIRE(after.grows > before.grows);
+}
+
+TEST_CASE("stats - keeps the text of runtime format strings", "[stats]")
+{
+    const auto before = find_stats("runtime format string {}");
+    for (int i = 0; i < 3; ++i)
+    {
+        const std::string fmt_text = std::string{ "runtime format string" } + " {}";
+        REQUIRE_THAT(fmt::format(fmt_text)(i), matchers::equal_to("runtime format string " + std::to_string(i)));
+    }
+
+    const auto after = find_stats("runtime format string {}");
+    REQUIRE_THAT(after.format, matchers::equal_to("runtime format string {}"sv));
+    REQUIRE(after.calls - before.calls == 3);
+}
+
+TEST_CASE("stats - merges the counters of exited threads", "[stats]")
+{
+    static constexpr std::string_view fmt_text = "thread {}";
+    const auto before = find_stats(fmt_text);
+    const std::size_t thread_count = fmt::detail::stats_registry::instance().m_threads.size();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        std::thread{ [i] { fmt::format(fmt_text)(i); } }.join();
+    }
+
+    const auto after = find_stats(fmt_text);
+    REQUIRE(after.calls - before.calls == 10);
+    REQUIRE(after.bytes - before.bytes == 80);
+    REQUIRE(fmt::detail::stats_registry::instance().m_threads.size() == thread_count);
+}